@@ -0,0 +1,67 @@
+#include "assets.h"
+#include "audio.h"
+
+const char *GetAssetBundlePath(void) {
+    return TextFormat("%s%s", GetApplicationDirectory(), ASSET_BUNDLE_FILE);
+}
+
+static bool OpenBenchmarkAssets(int path, AssetBundle *bundle) {
+    switch (path) {
+        case 0: return SearchAndSetResourceDir("resources");
+        case 1: return OpenAssetBundle(bundle, GetAssetBundlePath());
+#ifdef EMBED_ASSETS
+        case 2: return OpenAssetBundleMemory(bundle, embeddedAssets, embeddedAssetsSize);
+#endif
+        default: return false;
+    }
+}
+
+int RunAssetBenchmark(const Config *config) {
+    SetConfigFlags(FLAG_WINDOW_HIDDEN); // For the timer
+    InitWindow(320, 180, "Pong asset benchmark");
+
+    char workingDir[1024];
+    snprintf(workingDir, sizeof(workingDir), "%s", GetWorkingDirectory());
+
+    const char *names[] = { "directory search + files", "mapped bundle", "embedded bundle" };
+#ifdef EMBED_ASSETS
+    const int paths = 3;
+#else
+    const int paths = 2;
+#endif
+
+    // Every path as at startup: find the assets, then decode every sound. The first
+    // run may read from disk, the rest come from the page cache.
+    double first[3] = { 0 }, total[3] = { 0 }, best[3] = { 1e9, 1e9, 1e9 }, locate[3] = { 0 };
+    for (int run = 0; run < config->assetBenchmark; run++) {
+        for (int path = 0; path < paths; path++) {
+            AssetBundle bundle = { 0 };
+            double start = GetTime();
+            bool found = OpenBenchmarkAssets(path, &bundle);
+            double located = GetTime();
+            if (!found) {
+                TraceLog(LOG_ERROR, "ASSETS: no assets for the %s path", names[path]);
+                CloseWindow();
+                return 1;
+            }
+            for (int effect = 0; effect < SOUND_COUNT; effect++) UnloadWave(LoadGameWave((path == 0) ? NULL : &bundle, GetSoundFileName(effect)));
+            double time = GetTime() - start;
+
+            if (path == 0) ChangeDirectory(workingDir);
+            else CloseAssetBundle(&bundle);
+            if (run == 0) first[path] = time;
+            total[path] += time;
+            locate[path] += located - start;
+            if (time < best[path]) best[path] = time;
+        }
+    }
+
+    for (int path = 0; path < paths; path++) {
+        TraceLog(LOG_INFO, "ASSETS: %-24s first %.3f ms, avg %.3f ms (%.3f ms locating), best %.3f ms over %d runs", names[path],
+                 first[path] * 1000.0, total[path] / config->assetBenchmark * 1000.0,
+                 locate[path] / config->assetBenchmark * 1000.0, best[path] * 1000.0, config->assetBenchmark);
+    }
+
+    CloseWindow();
+    return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "game.h"
+
+// Where the asset bundle is looked for: next to the executable
+const char *GetAssetBundlePath(void);
+
+// Times each way of finding and decoding the sounds at startup, for --asset-bench
+int RunAssetBenchmark(const Config *config);
+
+#endif // ASSETS_H
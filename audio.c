@@ -0,0 +1,161 @@
+#include "audio.h"
+
+// Relative to the resources directory, and the names they have in the asset bundle
+static const char *soundFiles[SOUND_COUNT] = {
+    [SOUND_TOP] = "sounds/ping_pong_8bit_beeep.ogg",
+    [SOUND_EDGE] = "sounds/ping_pong_8bit_peeeeeep.ogg",
+    [SOUND_HIT] = "sounds/ping_pong_8bit_plop.ogg",
+};
+
+const char *GetSoundFileName(int effect) {
+    return soundFiles[effect];
+}
+
+Wave LoadGameWave(const AssetBundle *bundle, const char *fileName) {
+    if (bundle == NULL) return LoadWave(fileName);
+
+    // Decoded straight from the mapped file, no copy and no file open
+    int size = 0;
+    const unsigned char *data = FindAsset(bundle, fileName, &size);
+    if (data == NULL) {
+        TraceLog(LOG_WARNING, "BUNDLE: %s is not in the bundle", fileName);
+        return (Wave){ 0 };
+    }
+
+    // Sounds pre-decoded at build time keep their names but hold WAV data
+    bool decoded = (size >= 4 && memcmp(data, "RIFF", 4) == 0);
+    return LoadWaveFromMemory(decoded ? ".wav" : GetFileExtension(fileName), data, size);
+}
+
+static SoundPool LoadSoundPool(const AssetBundle *bundle, const char *fileName) {
+    SoundPool pool = { .lastStart = -SOUND_RATE_LIMIT };
+    int phase = BeginStartupPhase("LoadSound", fileName, "loader");
+    Wave wave = LoadGameWave(bundle, fileName);
+    pool.voices[0] = LoadSoundFromWave(wave);
+    UnloadWave(wave);
+    EndStartupPhase(phase);
+
+    // A missing or undecodable file leaves the whole pool empty, and silent
+    if (!IsSoundValid(pool.voices[0])) {
+        TraceLog(LOG_WARNING, "SOUNDS: %s could not be loaded, its effect stays silent", fileName);
+        return pool;
+    }
+    for (int i = 1; i < SOUND_VOICES; i++) pool.voices[i] = LoadSoundAlias(pool.voices[0]);
+    return pool;
+}
+
+static void PlaySoundPool(SoundPool *pool, double time) {
+    if (!IsSoundValid(pool->voices[0])) return;
+
+    // An edge-hugging ball bounces every tick; past the first bounce it is just mixer load
+    if (time - pool->lastStart < SOUND_RATE_LIMIT) {
+        pool->limited++;
+        return;
+    }
+    pool->lastStart = time;
+
+    // A free voice if there is one, otherwise the one that has played the longest
+    int voice = 0;
+    for (int i = 0; i < SOUND_VOICES; i++) {
+        if (!IsSoundPlaying(pool->voices[i])) {
+            voice = i;
+            break;
+        }
+        if (pool->started[i] < pool->started[voice]) voice = i;
+    }
+    if (IsSoundPlaying(pool->voices[voice])) pool->stolen++;
+
+    PlaySound(pool->voices[voice]); // Restarts a busy voice from the beginning
+    pool->started[voice] = time;
+    pool->played++;
+}
+
+void LoadGameSounds(Sounds *sounds, bool synth, GameEventQueue *events, const AssetBundle *bundle) {
+    if (synth) {
+        int phase = BeginStartupPhase("LoadSynth", NULL, "loader");
+        sounds->synth = LoadSynth(events); // No sound files are read at all
+        EndStartupPhase(phase);
+    }
+    else {
+        for (int effect = 0; effect < SOUND_COUNT; effect++) sounds->effects[effect] = LoadSoundPool(bundle, soundFiles[effect]);
+    }
+    atomic_store(&sounds->ready, true);
+}
+
+static void *AudioLoaderThread(void *arg) {
+    AudioLoader *loader = arg;
+    double start = GetTime();
+
+    int phase = BeginStartupPhase("InitAudioDevice", NULL, "loader");
+    InitAudioDevice();
+    EndStartupPhase(phase);
+    LoadGameSounds(loader->sounds, loader->synth, loader->events, loader->bundled ? &loader->bundle : NULL);
+    CloseAssetBundle(&loader->bundle); // Everything in it is decoded by now
+    MarkStartupPhase("audio_ready", "loader");
+
+    loader->loadTime = GetTime() - start;
+    loader->readyTime = GetTime();
+    return NULL;
+}
+
+void StartAudioLoader(AudioLoader *loader, Sounds *sounds, bool synth, GameEventQueue *events, const AssetBundle *bundle) {
+    *loader = (AudioLoader){ .sounds = sounds, .synth = synth, .events = events };
+    if (bundle != NULL) {
+        loader->bundle = *bundle; // The loader closes it
+        loader->bundled = true;
+    }
+    pthread_create(&loader->thread, NULL, AudioLoaderThread, loader);
+}
+
+void FinishAudioLoader(AudioLoader *loader) {
+    if (loader->joined) return;
+
+    double start = GetTime();
+    bool waited = !atomic_load(&loader->sounds->ready);
+    pthread_join(loader->thread, NULL);
+    loader->joined = true;
+    if (waited) loader->waitTime = GetTime() - start;
+
+    TraceLog(LOG_INFO, "AUDIO: device and sounds ready %.1f ms after InitWindow() started, %.1f ms of loading off the main thread, %.1f ms waited for",
+             loader->readyTime * 1000.0, loader->loadTime * 1000.0, loader->waitTime * 1000.0);
+}
+
+void PlayGameEvents(Sounds *sounds, GameEventQueue *events) {
+    // Until the sounds are loaded the events wait in the queue. The synth's callback
+    // consumes the queue itself.
+    if (!atomic_load(&sounds->ready) || sounds->synth != NULL) return;
+
+    GameEvent event;
+    while (PollGameEvent(events, &event)) {
+        switch (event.type) {
+            case EVENT_WALL_BOUNCE: PlaySoundPool(&sounds->effects[SOUND_TOP], event.time); break;
+            case EVENT_GOAL: PlaySoundPool(&sounds->effects[SOUND_EDGE], event.time); break;
+            case EVENT_PADDLE_HIT: PlaySoundPool(&sounds->effects[SOUND_HIT], event.time); break;
+            default: break;
+        }
+    }
+}
+
+void UnloadGameSounds(Sounds *sounds) {
+    if (sounds->synth != NULL) {
+        UnloadSynth(sounds->synth);
+        return;
+    }
+
+    unsigned int played = 0, stolen = 0, limited = 0;
+    for (int effect = 0; effect < SOUND_COUNT; effect++) {
+        SoundPool *pool = &sounds->effects[effect];
+        played += pool->played;
+        stolen += pool->stolen;
+        limited += pool->limited;
+        if (!IsSoundValid(pool->voices[0])) continue;
+
+        // Aliases share the wave data, only the first voice frees it
+        for (int i = SOUND_VOICES - 1; i > 0; i--) UnloadSoundAlias(pool->voices[i]);
+        UnloadSound(pool->voices[0]);
+    }
+    if (played + limited > 0) {
+        TraceLog(LOG_INFO, "SOUNDS: %u played on %d voices per effect, %u stole a busy voice, %u rate limited",
+                 played, SOUND_VOICES, stolen, limited);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <pthread.h>
+
+#include "sim.h"
+#include "bundle.h"
+#include "startup.h"
+#include "synth.h"
+
+// Opens the audio device and loads the sounds on a background thread, so the
+// window and the menu are up while that happens
+typedef struct {
+    pthread_t thread;
+    bool joined;
+    Sounds *sounds;
+    bool synth;
+    GameEventQueue *events;
+    AssetBundle bundle;         // Owned by the loader thread until it is joined
+    bool bundled;
+
+    // Written by the loader thread, read after the join
+    double loadTime;
+    double readyTime;           // GetTime() when everything was loaded
+    double waitTime;            // Main thread time spent blocked on the loader
+} AudioLoader;
+
+const char *GetSoundFileName(int effect);
+Wave LoadGameWave(const AssetBundle *bundle, const char *fileName);
+void LoadGameSounds(Sounds *sounds, bool synth, GameEventQueue *events, const AssetBundle *bundle);
+void StartAudioLoader(AudioLoader *loader, Sounds *sounds, bool synth, GameEventQueue *events, const AssetBundle *bundle);
+void FinishAudioLoader(AudioLoader *loader);
+void PlayGameEvents(Sounds *sounds, GameEventQueue *events);
+void UnloadGameSounds(Sounds *sounds);
+
+#endif // AUDIO_H
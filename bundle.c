@@ -0,0 +1,105 @@
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include "bundle.h"
+
+// No raylib here: windows.h and raylib.h cannot share a translation unit
+
+static const unsigned char *MapFile(const char *fileName, size_t *size) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER length;
+    const unsigned char *data = NULL;
+    if (GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping); // The view keeps the mapping alive
+        }
+        *size = (size_t)length.QuadPart;
+    }
+    CloseHandle(file);
+    return data;
+#else
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) return NULL;
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if (fstat(file, &info) == 0 && info.st_size > 0) {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        *size = (size_t)info.st_size;
+    }
+    close(file); // The mapping stays valid
+    return (data == MAP_FAILED) ? NULL : data;
+#endif
+}
+
+static void UnmapFile(const unsigned char *data, size_t size) {
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap((void *)data, size);
+#endif
+}
+
+bool OpenAssetBundle(AssetBundle *bundle, const char *fileName) {
+    size_t size = 0;
+    const unsigned char *data = MapFile(fileName, &size);
+    if (data == NULL) {
+        *bundle = (AssetBundle){ 0 };
+        return false;
+    }
+
+    if (!OpenAssetBundleMemory(bundle, data, size)) {
+        UnmapFile(data, size);
+        return false;
+    }
+    bundle->mapped = true;
+    return true;
+}
+
+bool OpenAssetBundleMemory(AssetBundle *bundle, const unsigned char *data, size_t size) {
+    *bundle = (AssetBundle){ 0 };
+
+    // Everything the table of contents points at has to be inside the bundle
+    const AssetBundleHeader *header = (const AssetBundleHeader *)data;
+    bool valid = size >= sizeof(AssetBundleHeader) && memcmp(header->magic, ASSET_BUNDLE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->count <= (size - sizeof(AssetBundleHeader)) / sizeof(AssetEntry);
+    const AssetEntry *entries = (const AssetEntry *)(data + sizeof(AssetBundleHeader));
+    for (uint32_t i = 0; valid && i < header->count; i++) {
+        valid = entries[i].name[ASSET_NAME_SIZE - 1] == '\0' && entries[i].offset <= size && entries[i].size <= size - entries[i].offset;
+    }
+    if (!valid) return false;
+
+    *bundle = (AssetBundle){ .data = data, .size = size, .entries = entries, .count = (int)header->count };
+    return true;
+}
+
+const unsigned char *FindAsset(const AssetBundle *bundle, const char *name, int *size) {
+    // A handful of entries, a linear scan beats building an index
+    for (int i = 0; i < bundle->count; i++) {
+        if (strcmp(bundle->entries[i].name, name) != 0) continue;
+        *size = (int)bundle->entries[i].size;
+        return bundle->data + bundle->entries[i].offset;
+    }
+    return NULL;
+}
+
+void CloseAssetBundle(AssetBundle *bundle) {
+    if (bundle->mapped) UnmapFile(bundle->data, bundle->size);
+    *bundle = (AssetBundle){ 0 };
+}
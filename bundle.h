@@ -0,0 +1,48 @@
+#ifndef BUNDLE_H
+#define BUNDLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ASSET_BUNDLE_FILE "assets.pak"
+#define ASSET_BUNDLE_MAGIC "PONGPAK1"
+#define ASSET_NAME_SIZE 56              // Including the terminating zero
+#define ASSET_ALIGNMENT 16              // Every asset starts on this boundary in the file
+
+// On-disk layout, little endian: the header, the table of contents, then the asset
+// data. Offsets are from the start of the file, so an asset is used in place.
+typedef struct {
+    char magic[8];
+    uint32_t count;
+    uint32_t reserved;
+} AssetBundleHeader;
+
+typedef struct {
+    char name[ASSET_NAME_SIZE];         // Path relative to the resources directory, like "sounds/x.ogg"
+    uint32_t offset;
+    uint32_t size;
+} AssetEntry;
+
+// A bundle mapped read-only into memory. Opening it is one file open and one map,
+// the pages of an asset are only read from disk when something decodes it.
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    const AssetEntry *entries;
+    int count;
+    bool mapped;                        // False for a bundle compiled into the executable
+} AssetBundle;
+
+#ifdef EMBED_ASSETS
+// assets.pak as a constant array, generated by the embed tool at build time
+extern const unsigned char *const embeddedAssets;
+extern const unsigned int embeddedAssetsSize;
+#endif
+
+bool OpenAssetBundle(AssetBundle *bundle, const char *fileName);
+bool OpenAssetBundleMemory(AssetBundle *bundle, const unsigned char *data, size_t size);
+const unsigned char *FindAsset(const AssetBundle *bundle, const char *name, int *size);
+void CloseAssetBundle(AssetBundle *bundle);
+
+#endif // BUNDLE_H
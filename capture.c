@@ -0,0 +1,225 @@
+#include "capture.h"
+
+// From the OpenGL 1.1 API every desktop driver exports: rlgl only reads the screen
+// into a fresh allocation, this reads it straight into a pool slot, last row first
+#if defined(_WIN32)
+#define GL_APIENTRY __stdcall
+#else
+#define GL_APIENTRY
+#endif
+#define GL_RGBA 0x1908
+#define GL_UNSIGNED_BYTE 0x1401
+void GL_APIENTRY glReadPixels(int x, int y, int width, int height, unsigned int format, unsigned int type, void *pixels);
+
+static unsigned char ClampByte(int value) {
+    return (unsigned char)((value < 0) ? 0 : (value > 255) ? 255 : value);
+}
+
+// Full range BT.601 4:2:0, what the Y4M C420jpeg tag announces. A negative stride
+// reads a bottom-up frame.
+static void ConvertToI420(const unsigned char *rgba, ptrdiff_t stride, int width, int height, unsigned char *planes) {
+    unsigned char *y = planes;
+    unsigned char *u = y + width * height;
+    unsigned char *v = u + (width / 2) * (height / 2);
+
+    for (int row = 0; row < height; row++) {
+        const unsigned char *pixel = rgba + row * stride;
+        for (int column = 0; column < width; column++, pixel += 4)
+            y[row * width + column] = (77 * pixel[0] + 150 * pixel[1] + 29 * pixel[2] + 128) >> 8;
+    }
+
+    for (int row = 0; row < height; row += 2) {
+        for (int column = 0; column < width; column += 2) {
+            // Average the 2x2 block each chroma sample covers
+            const unsigned char *top = rgba + row * stride + column * 4;
+            const unsigned char *bottom = top + stride;
+            int r = top[0] + top[4] + bottom[0] + bottom[4];
+            int g = top[1] + top[5] + bottom[1] + bottom[5];
+            int b = top[2] + top[6] + bottom[2] + bottom[6];
+
+            int index = (row / 2) * (width / 2) + column / 2;
+            u[index] = ClampByte((-43 * r - 85 * g + 128 * b) / 1024 + 128);
+            v[index] = ClampByte((128 * r - 107 * g - 21 * b) / 1024 + 128);
+        }
+    }
+}
+
+// Into the planes buffer, top row first whichever way the frame was stored
+static void ConvertCaptureFrame(FrameCapture *capture, const unsigned char *rgba) {
+    ptrdiff_t stride = (ptrdiff_t)capture->width * 4;
+    if (capture->bottomUp) {
+        rgba += (capture->height - 1) * stride;
+        stride = -stride;
+    }
+
+    if (capture->y4m) ConvertToI420(rgba, stride, capture->width, capture->height, capture->planes);
+    else {
+        for (int row = 0; row < capture->height; row++)
+            memcpy(capture->planes + (size_t)row * capture->width * 4, rgba + row * stride, (size_t)capture->width * 4);
+    }
+}
+
+// One timeline slot of the last converted frame
+static void WriteCapturePlanes(FrameCapture *capture) {
+    size_t pixels = (size_t)capture->width * capture->height;
+    if (capture->y4m) {
+        fputs("FRAME\n", capture->file);
+        fwrite(capture->planes, 1, pixels * 3 / 2, capture->file);
+    }
+    else fwrite(capture->planes, 4, pixels, capture->file);
+    atomic_fetch_add(&capture->written, 1);
+}
+
+// Holds the last frame over the timeline up to the given slot
+static void RepeatCaptureFrame(FrameCapture *capture, unsigned int slot) {
+    while (atomic_load(&capture->written) > 0 && atomic_load(&capture->written) < slot) {
+        WriteCapturePlanes(capture);
+        atomic_fetch_add(&capture->repeated, 1);
+    }
+}
+
+static void *EncoderThread(void *arg) {
+    FrameCapture *capture = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&capture->wakeLock);
+        while (atomic_load(&capture->running) && atomic_load(&capture->tail) == atomic_load(&capture->head))
+            pthread_cond_wait(&capture->wake, &capture->wakeLock);
+        pthread_mutex_unlock(&capture->wakeLock);
+
+        // Stopping still drains whatever was queued
+        unsigned int tail = atomic_load(&capture->tail);
+        if (tail == atomic_load(&capture->head)) {
+            if (!atomic_load(&capture->running)) break;
+            continue;
+        }
+
+        unsigned int index = tail & (CAPTURE_POOL_FRAMES - 1);
+        RepeatCaptureFrame(capture, capture->slots[index]);
+        ConvertCaptureFrame(capture, capture->frames[index]);
+        atomic_store(&capture->tail, tail + 1); // Hands the slot back to the game thread, planes has the frame
+        WriteCapturePlanes(capture);
+    }
+
+    return NULL;
+}
+
+FrameCapture *StartFrameCapture(const char *fileName, int width, int height, int fps, bool readback) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "CAPTURE: Failed to open %s", fileName);
+        return NULL;
+    }
+
+    FrameCapture *capture = calloc(1, sizeof(FrameCapture));
+    capture->file = file;
+    capture->y4m = (strcmp(GetFileExtension(fileName), ".y4m") == 0);
+    capture->width = width & ~1;
+    capture->height = height & ~1;
+    capture->bottomUp = readback;
+    capture->fps = fps;
+    capture->origin = -1.0;
+
+    // Every buffer is allocated here, recording allocates nothing per frame
+    size_t frameSize = (size_t)capture->width * capture->height * 4;
+    for (int i = 0; i < CAPTURE_POOL_FRAMES; i++) capture->frames[i] = malloc(frameSize);
+    capture->planes = malloc(frameSize);
+    capture->canvas = GenImageColor(capture->width, capture->height, BLANK);
+
+    if (capture->y4m) fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", capture->width, capture->height, fps);
+
+    pthread_mutex_init(&capture->wakeLock, NULL);
+    pthread_cond_init(&capture->wake, NULL);
+    atomic_store(&capture->running, true);
+    pthread_create(&capture->thread, NULL, EncoderThread, capture);
+
+    TraceLog(LOG_INFO, "CAPTURE: Recording %dx%d %s at %d fps to %s", capture->width, capture->height,
+             capture->y4m ? "Y4M" : "raw RGBA", fps, fileName);
+    return capture;
+}
+
+static void CopyCaptureRows(unsigned char *frame, const Image *image, int width, int height) {
+    for (int row = 0; row < height; row++)
+        memcpy(frame + (size_t)row * width * 4, (const unsigned char *)image->data + (size_t)row * image->width * 4, (size_t)width * 4);
+}
+
+void CaptureFrame(FrameCapture *capture, const Renderer *renderer) {
+    atomic_fetch_add(&capture->captured, 1);
+
+    // Faster than the file's rate, later frames in a slot lose to the first. Nearest
+    // slot, not the one started: at the file's own rate frames jitter around the
+    // slot boundaries, and flooring would push every early one into a taken slot.
+    double now = GetTime();
+    if (capture->origin < 0.0) capture->origin = now;
+    unsigned int slot = (unsigned int)((now - capture->origin) * capture->fps + 0.5);
+    if (slot < capture->nextSlot) {
+        atomic_fetch_add(&capture->skipped, 1);
+        return;
+    }
+
+    unsigned int head = atomic_load_explicit(&capture->head, memory_order_relaxed);
+    unsigned int depth = head - atomic_load(&capture->tail);
+    if (depth > capture->maxDepth) capture->maxDepth = depth;
+    if (depth == CAPTURE_POOL_FRAMES) {
+        atomic_fetch_add(&capture->dropped, 1);
+        return;
+    }
+
+    unsigned char *frame = capture->frames[head & (CAPTURE_POOL_FRAMES - 1)];
+    if (renderer->backend == BACKEND_RAYLIB) {
+        // The top rows of the back buffer, which counts rows from the bottom
+        int y = GetRenderHeight() - capture->height;
+        if (y < 0 || GetRenderWidth() < capture->width) {
+            atomic_fetch_add(&capture->dropped, 1);
+            return;
+        }
+        rlDrawRenderBatchActive(); // The back buffer must hold the whole frame
+        glReadPixels(0, y, capture->width, capture->height, GL_RGBA, GL_UNSIGNED_BYTE, frame);
+    }
+    // The software backend has already rasterized the frame at playfield size
+    else if (renderer->backend == BACKEND_SOFTWARE) CopyCaptureRows(frame, &renderer->canvas, capture->width, capture->height);
+    else {
+        // No frame of the video's size to copy, so the draw list goes through the CPU rasterizer
+        Image *canvas = &capture->canvas;
+        RasterizeDrawList(&renderer->commands, canvas, true);
+        CopyCaptureRows(frame, canvas, capture->width, capture->height);
+    }
+
+    capture->slots[head & (CAPTURE_POOL_FRAMES - 1)] = slot;
+    capture->nextSlot = slot + 1;
+    atomic_store(&capture->head, head + 1);
+
+    pthread_mutex_lock(&capture->wakeLock);
+    pthread_cond_signal(&capture->wake);
+    pthread_mutex_unlock(&capture->wakeLock);
+}
+
+unsigned int GetCaptureQueueDepth(FrameCapture *capture) {
+    return atomic_load(&capture->head) - atomic_load(&capture->tail);
+}
+
+void StopFrameCapture(FrameCapture *capture) {
+    if (capture == NULL) return;
+
+    pthread_mutex_lock(&capture->wakeLock);
+    atomic_store(&capture->running, false);
+    pthread_cond_signal(&capture->wake);
+    pthread_mutex_unlock(&capture->wakeLock);
+
+    pthread_join(capture->thread, NULL);
+    pthread_cond_destroy(&capture->wake);
+    pthread_mutex_destroy(&capture->wakeLock);
+
+    // The last frame stays on screen until the recording ends
+    if (capture->origin >= 0.0) RepeatCaptureFrame(capture, (unsigned int)((GetTime() - capture->origin) * capture->fps));
+
+    TraceLog(LOG_INFO, "CAPTURE: %u frames, %u skipped, %u dropped; %u written at %d fps, %u of them repeats; queue depth at most %u of %d",
+             atomic_load(&capture->captured), atomic_load(&capture->skipped), atomic_load(&capture->dropped),
+             atomic_load(&capture->written), capture->fps, atomic_load(&capture->repeated), capture->maxDepth, CAPTURE_POOL_FRAMES);
+
+    fclose(capture->file);
+    for (int i = 0; i < CAPTURE_POOL_FRAMES; i++) free(capture->frames[i]);
+    free(capture->planes);
+    UnloadImage(capture->canvas);
+    free(capture);
+}
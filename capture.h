@@ -0,0 +1,56 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "game.h"
+
+#define CAPTURE_POOL_FRAMES 8       // Power of two; frames in flight between the game and the encoder
+
+// Records rendered frames to a Y4M (4:2:0) or raw RGBA file. The game thread copies
+// each frame into a preallocated pool slot and moves on; a background thread
+// converts and writes it, so the game thread never waits on the disk. With every
+// slot still queued the frame is dropped rather than waited for.
+//
+// The file runs at a fixed rate while the game does not (idle scenes sleep, frames
+// run late), so each frame takes the timeline slot of the time it was captured:
+// the encoder repeats the previous frame over slots nothing arrived for, and a
+// frame whose slot is already taken is skipped before it is read back.
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t wakeLock;
+    pthread_cond_t wake;
+    atomic_bool running;
+
+    FILE *file;
+    bool y4m;                   // Otherwise raw RGBA frames back to back
+    int width;                  // Even, as 4:2:0 needs
+    int height;
+    Image canvas;               // Rasterizer target for the backends that leave no frame of the video size
+    bool bottomUp;              // Frames are read back from the GPU, last row first
+    int fps;
+    double origin;              // GetTime() of the first frame, timeline slot 0; negative before it
+    unsigned int nextSlot;      // First timeline slot no frame has taken, game thread only
+
+    // Single producer/single consumer ring over the frame pool
+    unsigned char *frames[CAPTURE_POOL_FRAMES];
+    unsigned int slots[CAPTURE_POOL_FRAMES];    // Timeline slot of each pooled frame
+    atomic_uint head;           // Next slot to fill, advanced by the game thread
+    atomic_uint tail;           // Next slot to encode, advanced by the encoder thread
+    unsigned char *planes;      // Encoder thread's output for the last frame, written again to fill gaps
+
+    atomic_uint captured;
+    atomic_uint skipped;        // Frames that arrived for a timeline slot already taken
+    atomic_uint dropped;        // Frames lost to a full pool
+    atomic_uint written;        // Timeline slots written, repeats included
+    atomic_uint repeated;
+    unsigned int maxDepth;      // Deepest the queue got, read on the game thread
+} FrameCapture;
+
+FrameCapture *StartFrameCapture(const char *fileName, int width, int height, int fps, bool readback);
+void CaptureFrame(FrameCapture *capture, const Renderer *renderer);
+unsigned int GetCaptureQueueDepth(FrameCapture *capture);
+void StopFrameCapture(FrameCapture *capture);
+
+#endif // CAPTURE_H
@@ -0,0 +1,19 @@
+// Decodes a sound to 16-bit PCM WAV at build time, so the game skips the decoder
+//   decode INPUT OUTPUT.wav
+
+#include "raylib.h"
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        TraceLog(LOG_ERROR, "usage: %s INPUT OUTPUT.wav", argv[0]);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    Wave wave = LoadWave(argv[1]);
+    if (!IsWaveValid(wave)) return 1;
+    WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+    bool ok = ExportWave(wave, argv[2]);
+    UnloadWave(wave);
+    return ok ? 0 : 1;
+}
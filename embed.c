@@ -0,0 +1,48 @@
+// Turns a file into C source the executable links, see EMBED_ASSETS in bundle.h
+//   embed OUTPUT.c SYMBOL INPUT
+// defines `const unsigned char *const SYMBOL` and `const unsigned int SYMBOLSize`.
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s OUTPUT.c SYMBOL INPUT\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(argv[3], "rb");
+    if (in == NULL) {
+        fprintf(stderr, "embed: cannot read %s\n", argv[3]);
+        return 1;
+    }
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    unsigned char *data = malloc(size + 1);
+    if (fread(data, 1, size, in) != (size_t)size) {
+        fprintf(stderr, "embed: cannot read %s\n", argv[3]);
+        return 1;
+    }
+    fclose(in);
+
+    FILE *out = fopen(argv[1], "w");
+    if (out == NULL) {
+        fprintf(stderr, "embed: cannot write %s\n", argv[1]);
+        return 1;
+    }
+
+    // The union aligns the bytes for the bundle's header and table of contents
+    fprintf(out, "// Generated from %s by embed, do not edit\n\n", argv[3]);
+    fprintf(out, "static const union {\n    unsigned char bytes[%ld];\n    unsigned long long align;\n} data = { {", size + 1);
+    for (long i = 0; i < size; i++) fprintf(out, "%s%u,", (i % 20 == 0) ? "\n    " : "", data[i]);
+    fprintf(out, "\n} };\n\n");
+    fprintf(out, "const unsigned char *const %s = data.bytes;\n", argv[2]);
+    fprintf(out, "const unsigned int %sSize = %ld;\n", argv[2], size);
+    bool ok = (fclose(out) == 0);
+
+    printf("embed: %ld bytes of %s as %s in %s\n", size, argv[3], argv[2], argv[1]);
+    free(data);
+    return ok ? 0 : 1;
+}
@@ -1,293 +1,974 @@
 #include "game.h"
-
-// #define DEV_MODE
-
-int main(void) {
-    SearchAndSetResourceDir("resources");
+#include "sim.h"
+#include "capture.h"
+#include "particles.h"
+#include "audio.h"
+#include "assets.h"
+#include "startup.h"
+
+int main(int argc, char **argv) {
+    StartStartupProfile();
+    Config config = ParseConfig(argc, argv);
+
+    // The golden images live relative to the working directory, not among the resources
+    if (config.goldenDir != NULL) return RunGoldenTests(&config);
+    if (config.wallMatches > 0) return RunWallView(&config);
+    if (config.assetBenchmark > 0) return RunAssetBenchmark(&config);
 
     SetTraceLogLevel( LOG_ALL );
-    SetConfigFlags( FLAG_VSYNC_HINT | FLAG_MSAA_4X_HINT);
-    InitWindow(screenWidth, screenHeight, "Pong Game");
-    SetTargetFPS(60);
-
-    InitAudioDevice();
-    Sound sn_beep = LoadSound("sounds/ping_pong_8bit_beeep.ogg");
-    Sound sn_peep = LoadSound("sounds/ping_pong_8bit_peeeeeep.ogg");
-    Sound sn_plop = LoadSound("sounds/ping_pong_8bit_plop.ogg");
-
-    GameState state = {
-        .leftScore = 0,
-        .rightScore = 0,
-        .isPaused = false,
-        .currentScene = MAIN_MENU,
-        .prevScene = 0,
-        .sounds = {.top = sn_beep, .edge = sn_peep, .hit = sn_plop},
-        .aiPlayer = true,
-    };
+    if (config.backend == BACKEND_TERMINAL) SetTraceLogCallback(TraceLogToStderr); // stdout carries the frames
+
+    // All assets come from one mapped file next to the executable; without it, look
+    // for the resources directory and load the loose files from there. An embedded
+    // build carries the bundle itself and touches no file at all.
+    int phase = BeginStartupPhase("assets_locate", NULL, "main");
+    AssetBundle bundle;
+#ifdef EMBED_ASSETS
+    bool bundled = OpenAssetBundleMemory(&bundle, embeddedAssets, embeddedAssetsSize);
+    if (bundled) TraceLog(LOG_INFO, "BUNDLE: %d assets embedded in the executable", bundle.count);
+#else
+    bool bundled = OpenAssetBundle(&bundle, GetAssetBundlePath());
+    if (bundled) TraceLog(LOG_INFO, "BUNDLE: %d assets mapped from %s", bundle.count, GetAssetBundlePath());
+#endif
+    else SearchAndSetResourceDir("resources");
+    EndStartupPhase(phase);
+
+    unsigned int flags = 0;
+    if (config.backend == BACKEND_TERMINAL) flags |= FLAG_WINDOW_HIDDEN;
+    if (config.vsync) flags |= FLAG_VSYNC_HINT;
+    if (config.msaa) flags |= FLAG_MSAA_4X_HINT;
+    SetConfigFlags(flags | FLAG_WINDOW_RESIZABLE);
+    phase = BeginStartupPhase("InitWindow", NULL, "main");
+    InitWindow(playfieldWidth, playfieldHeight, "Pong Game");
+    EndStartupPhase(phase);
+    SetWindowMinSize(playfieldWidth / 4, playfieldHeight / 4);
+    ResolveRenderMode(&config);
+    // No SetTargetFPS(): WaitForNextFrame() paces the loop and samples input while it waits
 
     SetExitKey(KEY_NULL);
-    bool exitWindow = false;    // Flag to set window to exit
 
-#ifdef DEV_MODE
-    state.currentScene = PREGAME;
-#endif
+    // The simulation runs on its own thread at a fixed tick and publishes snapshots;
+    // this thread samples input and draws, interpolating between the last two snapshots.
+    // What happens in the game reaches sounds, effects and stats through event queues.
+    Simulation sim;
+    InitSimulation(&sim, &config);
+
+    // Audio comes up in the background while the menu is already on screen
+    AudioLoader audio;
+    StartAudioLoader(&audio, &sim.sounds, config.synth, &sim.events.queues[EVENT_CONSUMER_AUDIO], bundled ? &bundle : NULL);
+    EventStats stats = { 0 };
+
+    GameSnapshot prev, next, view;
+    ReadSnapshot(&sim, &next);
+    prev = next;
+    StartSimulation(&sim);
+
+    Renderer renderer;
+    InitRenderer(&renderer, &config);
+    FrameScheduler scheduler = {
+        .mode = SCHEDULE_ACTIVE,
+        .targetFps = config.targetFps,
+        .headless = (config.backend == BACKEND_TERMINAL),
+        .frameStart = GetTime(),
+    };
+    FramePacer pacer = { .mode = config.pacing, .presentInterval = 1.0 / TARGET_FPS };
+    InputSampler sampler = { .synthetic = config.latencyTest };
+    // The hidden window never has focus, so the keys come from the terminal instead
+    if (config.backend == BACKEND_TERMINAL) sampler.terminal = StartTerminalInput();
+    LatencyProbe *probe = config.latencyTest ? calloc(1, sizeof(LatencyProbe)) : NULL;
+
+    ParticleSystem particles;
+    InitParticles(&particles, config.particleStress);
+    double lastFrameStart = scheduler.frameStart;
+    double firstFrameTime = 0.0;
+    int stallsLeft = config.stallTest;
+    double nextStall = scheduler.frameStart + STALL_TEST_PERIOD;
+    double benchmarkEnd = scheduler.frameStart + config.benchmark;
+
+    FrameCapture *capture = NULL;
+    if (config.captureFile != NULL) {
+        // The video has one size, read back frames have the window's
+        bool readback = (config.backend == BACKEND_RAYLIB);
+        if (readback) ClearWindowState(FLAG_WINDOW_RESIZABLE);
+        capture = StartFrameCapture(config.captureFile, readback ? GetRenderWidth() : playfieldWidth,
+                                    readback ? GetRenderHeight() : playfieldHeight, (config.targetFps > 0) ? config.targetFps : TARGET_FPS, readback);
+    }
+
+    while (!next.state.exitRequested) {
+        if (probe != NULL && probe->count >= config.latencySamples) break;
+        if (config.stallTest > 0 && stallsLeft == 0 && GetTime() >= nextStall) break;
+        if (config.benchmark > 0 && GetTime() >= benchmarkEnd) break;
 
-    Paddle leftPaddle = {{50, (int)((screenHeight / 2)) - (PADDLE_HEIGHT / 2), PADDLE_WIDTH, PADDLE_HEIGHT}, 500.0f};
-    Paddle rightPaddle = {{screenWidth - 50 - PADDLE_WIDTH, (int)((screenHeight / 2)) - (PADDLE_HEIGHT / 2), PADDLE_WIDTH, PADDLE_HEIGHT}, 500.0f};
-    Ball ball = {(Vector2){(int)(screenWidth / 2),(int)( screenHeight / 2)}, (Vector2){1.0f, 1.0f}, BALL_SPEED}; // Direction normalized
+        BeginSchedulerFrame(&scheduler);
 
-    ResetBall(&ball); // Initial reset
+        SampleInput(&sampler, &sim);
 
-    while (!exitWindow) {
-        if (WindowShouldClose() || IsKeyPressed(KEY_ESCAPE)) {
-            state.prevScene = state.currentScene;
-            state.currentScene = EXIT_WINDOW;
+        bool changed = false;
+        GameSnapshot latest;
+        while (ReadSnapshot(&sim, &latest)) {
+            changed |= IsSnapshotChanged(&next, &latest);
+            prev = next;
+            next = latest;
         }
+        // Render one tick behind the simulation so there is always a snapshot on each side
+        InterpolateSnapshot(&prev, &next, GetTime() - SIM_DT, &view);
+        UpdateBallTrail(&renderer.trail, &next.ball, &next.state, next.time, view.time);
+        if (probe != NULL) UpdateLatencyProbe(probe, view.rightPaddle.rect.y, next.presses, next.lastPressTime);
+
+        // Only the first gameplay frame can wait for sounds still loading
+        if (view.state.currentScene == GAME) FinishAudioLoader(&audio);
+        PlayGameEvents(&sim.sounds, &sim.events.queues[EVENT_CONSUMER_AUDIO]);
+        SpawnGameEffects(&particles, &sim.events.queues[EVENT_CONSUMER_EFFECTS]);
+        UpdateEventStats(&stats, &sim.events.queues[EVENT_CONSUMER_STATS], next.tick);
+        UpdateParticles(&particles, (float)fmin(scheduler.frameStart - lastFrameStart, 0.1));
+        lastFrameStart = scheduler.frameStart;
+
+        // Keep full rate while input or changed snapshots are in flight, and until the
+        // interpolated view has caught up with them, so the frame that shows their result
+        // is drawn before the loop goes back to waiting for events. Synthetic presses
+        // are not window events, nothing would wake the wait for them.
+        bool busy = sampler.events > 0 || sampler.synthetic || stallsLeft > 0 || changed || IsSnapshotChanged(&view, &next) || particles.count > 0;
+        if (UpdateFrameScheduler(&scheduler, busy)) PulseInput(&sim, INPUT_SUSPEND);
+        sampler.events = 0;
+
+        // Layout work happens once per resize, not per frame
+        if (UpdateViewLayout(&renderer.layout) && renderer.backend == BACKEND_RAYLIB)
+            UpdatePlayfieldLayer(&renderer.playfield, renderer.layout.scale);
+        UpdateTextCache(&renderer.text, &view.state);
+
+        BuildScene(&renderer.commands, &renderer.text, &view.leftPaddle, &view.rightPaddle, &view.ball, &view.state,
+                   &renderer.trail, &particles);
+
+        // Static scenes are rendered once and presented until they change, once the
+        // last sparks over them have died
+        bool retained = IsStaticScene(&view.state) && particles.count == 0;
 
-        if (state.currentScene == EXIT_WINDOW) {
-            if (IsKeyPressed(KEY_Y)) exitWindow = true;
-            else if (IsKeyPressed(KEY_N)) state.currentScene = state.prevScene;
+        BeginDrawing();
+        RenderScene(&renderer, &view.state, retained);
+        if (capture != NULL) CaptureFrame(capture, &renderer); // Before the overlays
+        if (probe != NULL) DrawLatencyProbe(probe);
+#ifdef DEV_MODE
+        DrawFPS(10, 10);
+        DrawText(TextFormat("idle %.1fs, ~%.2fs CPU saved", scheduler.idleTime, GetSchedulerCpuSaved(&scheduler)), 10, 30, 10, LIME);
+        DrawText(TextFormat("sim: %u late ticks, max lag %.1f ms (F9: stall render)",
+                 atomic_load(&sim.lateTicks), atomic_load(&sim.maxTickLag) * 1000.0), 10, 45, 10, LIME);
+        DrawText(TextFormat("input: %u presses, avg %.2f ms, max %.2f ms sample-to-tick", atomic_load(&sim.inputPresses),
+                 GetInputLatencyAverage(&sim) * 1000.0, atomic_load(&sim.inputLatencyMax) * 1000.0), 10, 60, 10, LIME);
+        DrawText(TextFormat("pacing %s: %.1f fps, present every %.2f ms, work %.2f ms", GetPacingModeName(pacer.mode),
+                 1.0 / pacer.presentInterval, pacer.presentInterval * 1000.0, pacer.workTime * 1000.0), 10, 75, 10, LIME);
+        DrawText(TextFormat("resolution scale %.1f, live frames every %.2f ms", renderer.resolution.scale,
+                 renderer.resolution.presentInterval * 1000.0), 10, 90, 10, LIME);
+        DrawText(TextFormat("%s backend: %d draw commands in %d batches", GetRenderBackendName(renderer.backend),
+                 renderer.commands.count, renderer.commands.batches), 10, 105, 10, LIME);
+        DrawText(TextFormat("particles: %d live", particles.count), 10, 135, 10, LIME);
+        if (capture != NULL) {
+            DrawText(TextFormat("capture: queue %u/%d, %u dropped", GetCaptureQueueDepth(capture), CAPTURE_POOL_FRAMES,
+                     atomic_load(&capture->dropped)), 10, 120, 10, LIME);
+        }
+        if (IsKeyDown(KEY_F9)) WaitTime(0.25); // Inject a render stall, the simulation must keep its tick
+#endif
+        if (stallsLeft > 0 && GetTime() >= nextStall) {
+            WaitTime(STALL_TEST_DURATION); // The simulation must keep its tick meanwhile
+            nextStall = GetTime() + STALL_TEST_PERIOD;
+            stallsLeft--;
+        }
+        EndSchedulerFrame(&scheduler);
+        double work = GetTime() - scheduler.frameStart;
+        if (firstFrameTime == 0.0) phase = BeginStartupPhase("first_EndDrawing", NULL, "main");
+        EndDrawing();
+        if (firstFrameTime == 0.0) {
+            EndStartupPhase(phase);
+            MarkStartupPhase("first_frame", "main");
+            firstFrameTime = GetTime();
+            TraceLog(LOG_INFO, "STARTUP: first frame presented %.1f ms after InitWindow() started, sounds %s", firstFrameTime * 1000.0,
+                     atomic_load(&sim.sounds.ready) ? "ready" : "still loading");
+            if (config.exitAfterFirstFrame) break;
         }
+        EndFramePacing(&pacer, &scheduler, work);
 
-        switch (state.currentScene) {
-            case MAIN_MENU:
-                if (IsKeyPressed(KEY_ENTER)) {
-                    state.currentScene = PREGAME;
-
-                    state.aiPlayer = true;
-                }
-                else if (IsKeyPressed(KEY_SPACE)) {
-                    state.currentScene = GAME;
-                    state.aiPlayer = false;
-                }
-                else if (IsKeyPressed(KEY_ESCAPE)) {
-                    CloseWindow();
-                }
-                break;
-            case PREGAME:
-                if (IsKeyPressed(KEY_SPACE) or IsKeyPressed(KEY_ENTER)
-                    or IsKeyPressed(KEY_W) or IsKeyPressed(KEY_UP)
-                    or IsKeyPressed(KEY_S) or IsKeyPressed(KEY_DOWN))
-                    state.currentScene = GAME;
-                break;
-            case GAME:
-                if (!state.isPaused)
-                    GameLogic(&leftPaddle, &rightPaddle, &ball, &state);
-                if (IsKeyPressed(KEY_P)) {
-                    state.isPaused = !state.isPaused;
-                }
-                break;
-            case GAME_OVER:
-                ball.speed = 0.0f;
-                if (IsKeyPressed(KEY_R)) {
-                    state.leftScore = 0;
-                    state.rightScore = 0;
-                    ResetBall(&ball);
-                    state.currentScene = GAME;
-                }
-                else if (IsKeyPressed(KEY_M)) {
-                    state.currentScene = MAIN_MENU;
-                }
-                break;
-            default: break;
+        // Only live scenes are judged, retained and idle frames cost next to nothing
+        if (!retained && scheduler.mode == SCHEDULE_ACTIVE) {
+            double budget = 1.0 / ((config.targetFps > 0) ? config.targetFps : TARGET_FPS);
+            UpdateDynamicResolution(&renderer.resolution, pacer.lastInterval, budget);
         }
+        if (probe != NULL) EndLatencyProbeFrame(probe);
 
-        BeginDrawing();
-        switch (state.currentScene) {
-            case EXIT_WINDOW:
-                ClearBackground(DARKGRAY);
-                char * exit_str = "Are you sure you want to exit program? [Y/N]";
-                DrawText(exit_str, GetScreenWidth() / 2 - MeasureText(exit_str, 30) / 2, GetScreenHeight() / 2, 30, RAYWHITE);
-                break;
-            case MAIN_MENU:
-                ClearBackground(DARKGRAY);
-                Font defaultFont = GetFontDefault();
-                Vector2 origin = { 0, 0 };
-                float rotation = 0.0f; // No rotation
-                float fontSize = 40.0f; // Normal size
-                float spacing = 2.0f;
-                DrawTextPro(defaultFont, "PONG!", (Vector2){GetScreenWidth() / 2 - MeasureText("PONG!", fontSize) / 2, GetScreenHeight() / 2 - 80}, origin, rotation, fontSize, spacing, RAYWHITE);
-                DrawTextPro(defaultFont, "Play with AI (press Enter)", (Vector2){GetScreenWidth() / 2 - MeasureText("Play with AI (press 1)", 20) / 2, GetScreenHeight() / 2}, origin, rotation, 20, spacing, RAYWHITE);
-                DrawTextPro(defaultFont, "Local Two Player (press Space)", (Vector2){GetScreenWidth() / 2 - MeasureText("Play with AI (press 1)", 20) / 2, GetScreenHeight() / 2 + 40}, origin, rotation, 20, spacing, RAYWHITE);
-                DrawTextPro(defaultFont, "Exit (Press Escape)", (Vector2){GetScreenWidth() / 2 - MeasureText("Play with AI (press 1)", 20) / 2, GetScreenHeight() / 2 + 80}, origin, rotation, 20, spacing, RAYWHITE);
-                break;
-            case PREGAME:
-                ClearBackground(DARKGRAY);
-                DrawRectangleRec(leftPaddle.rect, LIGHTGRAY);
-                DrawRectangleRec(rightPaddle.rect, LIGHTGRAY);
-                DrawDashedLine(LIGHTGRAY);
-                DrawText(TextFormat("%d", state.leftScore), screenWidth / 4, 20, 80, LIGHTGRAY);
-                DrawText(TextFormat("%d", state.rightScore), 3 * screenWidth / 4, 20, 80, LIGHTGRAY);
-                DrawText(TextFormat("Press to start game."), (screenWidth / 2) - (screenWidth / 4), screenHeight / 3, 60, RAYWHITE);
-                break;
-            case GAME:
-                ClearBackground(DARKGRAY);
-                DrawRectangleRec(leftPaddle.rect, RAYWHITE);
-                DrawRectangleRec(rightPaddle.rect, RAYWHITE);
-                DrawCircleV(ball.position, BALL_SIZE / 2, RAYWHITE);
-                DrawDashedLine(RAYWHITE);
-                DrawText(TextFormat("%d", state.leftScore), screenWidth / 4, 20, 80, RAYWHITE);
-                DrawText(TextFormat("%d", state.rightScore), 3 * screenWidth / 4, 20, 80, RAYWHITE);
-                if (state.isPaused) {
-                    ClearBackground(DARKGRAY);
-                    DrawRectangleRec(leftPaddle.rect, LIGHTGRAY);
-                    DrawRectangleRec(rightPaddle.rect, LIGHTGRAY);
-                    DrawDashedLine(LIGHTGRAY);
-                    DrawText(TextFormat("Paused."), GetScreenWidth() / 2 - MeasureText("Paused", 60) / 2, screenHeight / 2, 60, RED);
-                    break;
-                }
-                break;
-            case GAME_OVER:
-                ClearBackground(DARKGRAY);
-                DrawRectangleRec(leftPaddle.rect, LIGHTGRAY);
-                DrawRectangleRec(rightPaddle.rect, LIGHTGRAY);
-                DrawDashedLine(LIGHTGRAY);
-                DrawText(TextFormat("%d", state.leftScore), screenWidth / 4, 20, 80, LIGHTGRAY);
-                DrawText(TextFormat("%d", state.rightScore), 3 * screenWidth / 4, 20, 80, LIGHTGRAY);
-                DrawText(TextFormat("Press R to restart game."), (screenWidth / 2) - (screenWidth / 4), screenHeight / 2, 60, RAYWHITE);
-                break;
-            }
-        EndDrawing();
+        WaitForNextFrame(&pacer, &scheduler, &sampler, &sim);
+    }
+
+    StopSimulation(&sim);
+    StopFrameCapture(capture);
+    bool stallTestFailed = (config.stallTest > 0 && !CheckStallTest(&sim, next.tick));
+
+    if (probe != NULL) {
+        WriteLatencyReport(probe, &config);
+        free(probe);
     }
 
     // De-Initialization
-    UnloadSound(sn_beep);
-    UnloadSound(sn_peep);
-    UnloadSound(sn_plop);
+    TraceLog(LOG_INFO, "SCHEDULER: %.1fs idle, %d idle frames, ~%.2fs CPU saved",
+             scheduler.idleTime, scheduler.idleFrames, GetSchedulerCpuSaved(&scheduler));
+    LogFramePacing(&pacer, &scheduler, &config);
+    LogParticles(&particles);
+    LogEventStats(&stats, &sim);
+    if (renderer.resolution.frames > 0) {
+        TraceLog(LOG_INFO, "RESOLUTION: final scale %.1f, %.1f%% of live frames within budget",
+                 renderer.resolution.scale, 100.0 * renderer.resolution.framesInBudget / renderer.resolution.frames);
+    }
+    if (renderer.terminal != NULL && renderer.terminal->frames > 0) {
+        TraceLog(LOG_INFO, "TERMINAL: %d frames, %.0f bytes per frame on average, %d at most",
+                 renderer.terminal->frames, (double)renderer.terminal->bytes / renderer.terminal->frames, renderer.terminal->maxBytes);
+    }
+    TraceLog(LOG_INFO, "SIM: %llu ticks, %u late, max lag %.2f ms",
+             next.tick, atomic_load(&sim.lateTicks), atomic_load(&sim.maxTickLag) * 1000.0);
+    TraceLog(LOG_INFO, "INPUT: %u presses, sample-to-tick avg %.2f ms, max %.2f ms, %u dropped",
+             atomic_load(&sim.inputPresses), GetInputLatencyAverage(&sim) * 1000.0,
+             atomic_load(&sim.inputLatencyMax) * 1000.0, atomic_load(&sim.droppedInputs));
+    UnloadParticles(&particles);
+    UnloadRenderer(&renderer);
+    StopTerminalInput();
+    FinishAudioLoader(&audio);
+    WriteStartupReport(TextFormat("%s%s", GetApplicationDirectory(), STARTUP_REPORT_FILE));
+    UnloadGameSounds(&sim.sounds);
     CloseAudioDevice();     // Close audio device
     CloseWindow(); // Close window and OpenGL context
 
-    return 0;
+    return stallTestFailed ? 1 : 0;
 }
 
-void GameLogic(Paddle *leftPaddle, Paddle *rightPaddle, Ball *ball, GameState *state) {
-    if (state->aiPlayer) {
-        if(ball->direction.x > 0) {
-        // If the ball is moving away from the left paddle
-        // Move the paddle slowly towards the center of the screen
-        float centerY = (screenHeight - leftPaddle->rect.height) / 2;
-        float distanceToCenter = centerY - (leftPaddle->rect.y + leftPaddle->rect.height / 2);
+void TraceLogToStderr(int logLevel, const char *text, va_list args) {
+    static const char *levels[] = { "", "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "FATAL", "" };
+    fprintf(stderr, "%s: ", levels[(logLevel >= 0 && logLevel <= LOG_NONE) ? logLevel : LOG_NONE]);
+    vfprintf(stderr, text, args);
+    fprintf(stderr, "\n");
+}
 
-        if (fabs(distanceToCenter) > 10.0f) { // Only move if the distance is significant
-            if (distanceToCenter > 0) {
-                leftPaddle->rect.y += (leftPaddle->speed) * GetFrameTime(); // Move down slowly
-            } else {
-                leftPaddle->rect.y -= (leftPaddle->speed) * GetFrameTime(); // Move up slowly
-            }
-        }
-        else {
-            leftPaddle = leftPaddle;
-        }
-        } else {
+void DrawDashedLine(Vector2 start, Vector2 end, float thick, Color color) {
+    Vector2 direction = Vector2Subtract(end, start);
+    float length = Vector2Length(direction);
+    direction = Vector2Normalize(direction);
 
-            // Calculate the target position based on the ball's position
-            float targetY = ball->position.y;
+    float totalLength = 0.0f;
+    while (totalLength < length) {
+        // Calculate the start and end points of the dash
+        Vector2 dashStart = Vector2Add(start, Vector2Scale(direction, totalLength));
+        Vector2 dashEnd = Vector2Add(dashStart, Vector2Scale(direction, DASH_LENGTH));
 
-            // Calculate the distance to the target position
-            float distance = targetY - (leftPaddle->rect.y + leftPaddle->rect.height / 2);
+        // Draw the dash
+        DrawLineEx(dashStart, dashEnd, thick, color);
 
-            // Move the paddle towards the ball's position
-            if (fabs(distance) > 1.0f) { // Only move if the distance is significant
-                if (distance > 0) {
-                    leftPaddle->rect.y += leftPaddle->speed * GetFrameTime(); // Move down
-                } else {
-                    leftPaddle->rect.y -= leftPaddle->speed * GetFrameTime(); // Move up
-                }
-            }
+        // Move the total length by the dash length and gap length
+        totalLength += DASH_LENGTH + DASH_GAP;
+    }
+}
 
-            // Clamp the paddle's position to stay within the game boundaries
-            if (leftPaddle->rect.y < 0) {
-                leftPaddle->rect.y = 0;
-            } else if (leftPaddle->rect.y > screenWidth - leftPaddle->rect.height) {
-                leftPaddle->rect.y = screenHeight - leftPaddle->rect.height;
-            }
-        }
+void InitRenderer(Renderer *renderer, const Config *config) {
+    *renderer = (Renderer){
+        .backend = config->backend,
+        .text = { .left.value = -1, .right.value = -1 },
+        .resolution = {
+            .enabled = config->dynamicResolution && config->backend == BACKEND_RAYLIB,
+            .scale = 1.0f,
+            .presentInterval = 1.0 / TARGET_FPS,
+            .probeFrames = RESOLUTION_PROBE_FRAMES,
+        },
+    };
+
+    // The scene cache and the dynamic resolution target are allocated on first use:
+    // other backends need neither, and a game that stays within budget no scaled target.
+    // Only the GPU path draws the baked playfield layer, the others rasterize the line.
+    UpdateViewLayout(&renderer->layout);
+    if (renderer->backend == BACKEND_RAYLIB) {
+        int height = (int)fmax(GetMonitorHeight(GetCurrentMonitor()), GetScreenHeight());
+        UpdatePlayfieldLayer(&renderer->playfield, fmaxf(renderer->layout.scale, (float)height / playfieldHeight));
+    }
+
+    InitArena(&renderer->commands.arena, DRAW_ARENA_SIZE);
+    if (renderer->backend == BACKEND_SOFTWARE) {
+        renderer->canvas = GenImageColor(playfieldWidth, playfieldHeight, BLANK);
+        renderer->canvasTexture = LoadTextureFromImage(renderer->canvas);
+        SetTextureFilter(renderer->canvasTexture, TEXTURE_FILTER_BILINEAR);
+    }
+    if (renderer->backend == BACKEND_TERMINAL) renderer->terminal = LoadTerminalRenderer();
+}
+
+void UnloadRenderer(Renderer *renderer) {
+    if (renderer->playfield.texture.id > 0) UnloadRenderTexture(renderer->playfield.texture);
+    if (renderer->scene.texture.id > 0) UnloadRenderTexture(renderer->scene.texture);
+    if (renderer->resolution.target.id > 0) UnloadRenderTexture(renderer->resolution.target);
+    if (renderer->canvasTexture.id > 0) UnloadTexture(renderer->canvasTexture);
+    UnloadImage(renderer->canvas);
+    UnloadTerminalRenderer(renderer->terminal);
+    FreeArena(&renderer->commands.arena);
+}
 
-        // Extended Player Input
-        if ((IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) && rightPaddle->rect.y > 0) {
-            rightPaddle->rect.y -= rightPaddle->speed * GetFrameTime();
+void EnsureRenderTarget(RenderTexture2D *target, int width, int height) {
+    if (target->id > 0 && target->texture.width >= width && target->texture.height >= height) return;
+
+    // The window cannot outgrow its monitor, so a target that size survives any resize.
+    // It only grows for a window moved to a larger monitor.
+    if (target->id == 0) {
+        int monitor = GetCurrentMonitor();
+        width = (int)fmax(width, GetMonitorWidth(monitor));
+        height = (int)fmax(height, GetMonitorHeight(monitor));
+    }
+    else {
+        width = (int)fmax(width, target->texture.width);
+        height = (int)fmax(height, target->texture.height);
+        UnloadRenderTexture(*target);
+    }
+    *target = LoadRenderTexture(width, height);
+    SetTextureFilter(target->texture, TEXTURE_FILTER_BILINEAR); // Upscaled by dynamic resolution
+}
+
+bool UpdateViewLayout(ViewLayout *layout) {
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
+    if (width <= 0 || height <= 0) return false; // Minimized, keep the last layout
+    if (layout->windowWidth == width && layout->windowHeight == height) return false;
+
+    layout->windowWidth = width;
+    layout->windowHeight = height;
+    layout->scale = fminf((float)width / playfieldWidth, (float)height / playfieldHeight);
+    layout->camera = (Camera2D){
+        .offset = { (width - playfieldWidth * layout->scale) / 2, (height - playfieldHeight * layout->scale) / 2 },
+        .target = { 0, 0 },
+        .rotation = 0.0f,
+        .zoom = layout->scale,
+    };
+    return true;
+}
+
+void UpdatePlayfieldLayer(PlayfieldLayer *layer, float scale) {
+    if (layer->texture.id > 0 && layer->scale >= scale) return;
+
+    if (layer->texture.id > 0) UnloadRenderTexture(layer->texture);
+
+    // Only the center strip holds anything, so keep the texture (and its fill cost) narrow
+    layer->texture = LoadRenderTexture(2 * DASH_THICKNESS * scale, playfieldHeight * scale);
+    layer->scale = scale;
+    SetTextureFilter(layer->texture.texture, TEXTURE_FILTER_BILINEAR);
+
+    BeginTextureMode(layer->texture);
+    ClearBackground(BLANK);
+    BeginMode2D((Camera2D){ .zoom = scale });
+    DrawDashedLine((Vector2){ DASH_THICKNESS, 0 }, (Vector2){ DASH_THICKNESS, playfieldHeight }, DASH_THICKNESS, WHITE);
+    EndMode2D();
+    EndTextureMode();
+}
+
+void DrawPlayfieldLayer(const PlayfieldLayer *layer, Color color) {
+    // Render textures are stored upside down, hence the negative source height
+    Rectangle source = { 0, 0, layer->texture.texture.width, -layer->texture.texture.height };
+    Rectangle dest = { (int)(playfieldWidth / 2) - DASH_THICKNESS, 0, 2 * DASH_THICKNESS, playfieldHeight };
+    DrawTexturePro(layer->texture.texture, source, dest, (Vector2){ 0, 0 }, 0.0f, color);
+}
+
+static void UpdateScoreText(ScoreText *score, int value) {
+    if (score->value == value) return;
+    score->value = value;
+    TextCopy(score->text, TextFormat("%d", value));
+}
+
+void UpdateTextCache(TextCache *cache, const GameState *state) {
+    UpdateScoreText(&cache->left, state->leftScore);
+    UpdateScoreText(&cache->right, state->rightScore);
+
+    if (cache->measured) return;
+    cache->measured = true;
+
+    int width = playfieldWidth;
+    int height = playfieldHeight;
+    int menuX = width / 2 - MeasureText(TEXT_MENU_ALIGN, 20) / 2;
+    cache->exitPrompt = (Vector2){ width / 2 - MeasureText(TEXT_EXIT_PROMPT, 30) / 2, height / 2 };
+    cache->title = (Vector2){ width / 2 - MeasureText("PONG!", 40) / 2, height / 2 - 80 };
+    cache->menuAi = (Vector2){ menuX, height / 2 };
+    cache->menuLocal = (Vector2){ menuX, height / 2 + 40 };
+    cache->menuExit = (Vector2){ menuX, height / 2 + 80 };
+    cache->paused = (Vector2){ width / 2 - MeasureText("Paused", 60) / 2, height / 2 };
+
+    cache->labels[LABEL_EXIT_PROMPT] = TEXT_EXIT_PROMPT;
+    cache->labels[LABEL_TITLE] = "PONG!";
+    cache->labels[LABEL_MENU_AI] = "Play with AI (press Enter)";
+    cache->labels[LABEL_MENU_LOCAL] = "Local Two Player (press Space)";
+    cache->labels[LABEL_MENU_EXIT] = "Exit (Press Escape)";
+    cache->labels[LABEL_SCORE_LEFT] = cache->left.text;
+    cache->labels[LABEL_SCORE_RIGHT] = cache->right.text;
+    cache->labels[LABEL_PRESS_START] = "Press to start game.";
+    cache->labels[LABEL_PAUSED] = "Paused.";
+    cache->labels[LABEL_RESTART] = "Press R to restart game.";
+}
+
+Config ParseConfig(int argc, char **argv) {
+    Config config = {
+        .vsync = true,
+        .msaa = true,
+        .targetFps = TARGET_FPS,
+        .pacing = PACING_HYBRID,
+        .dynamicResolution = true,
+        .latencyTest = false,
+        .latencySamples = 200,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-vsync") == 0) config.vsync = false;
+        else if (strcmp(argv[i], "--no-msaa") == 0) config.msaa = false;
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) config.targetFps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "vsync") == 0) config.renderMode = RENDER_VSYNC;
+            else if (strcmp(argv[i], "uncapped") == 0) config.renderMode = RENDER_UNCAPPED;
+            else if (atoi(argv[i]) > 0) {
+                config.renderMode = RENDER_CAPPED;
+                config.targetFps = atoi(argv[i]);
+            }
+            else TraceLog(LOG_WARNING, "CONFIG: Unknown render mode %s", argv[i]);
         }
-        if ((IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) && rightPaddle->rect.y < screenHeight - PADDLE_HEIGHT) {
-            rightPaddle->rect.y += rightPaddle->speed * GetFrameTime();
+        else if (strcmp(argv[i], "--pacing") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "sleep") == 0) config.pacing = PACING_SLEEP;
+            else if (strcmp(argv[i], "hybrid") == 0) config.pacing = PACING_HYBRID;
+            else if (strcmp(argv[i], "late") == 0) config.pacing = PACING_LATE;
+            else TraceLog(LOG_WARNING, "CONFIG: Unknown pacing mode %s", argv[i]);
         }
-    } else {
-        // Two PlayerInput
-        if (IsKeyDown(KEY_W) && leftPaddle->rect.y > 0) {
-            leftPaddle->rect.y -= leftPaddle->speed * GetFrameTime();
+        else if (strcmp(argv[i], "--no-dynamic-resolution") == 0) config.dynamicResolution = false;
+        else if (strcmp(argv[i], "--latency-test") == 0) config.latencyTest = true;
+        else if (strcmp(argv[i], "--latency-samples") == 0 && i + 1 < argc) config.latencySamples = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) config.goldenDir = argv[++i];
+        else if (strcmp(argv[i], "--golden-update") == 0 && i + 1 < argc) {
+            config.goldenDir = argv[++i];
+            config.goldenUpdate = true;
         }
-        if (IsKeyDown(KEY_S) && leftPaddle->rect.y < screenHeight - PADDLE_HEIGHT) {
-            leftPaddle->rect.y += leftPaddle->speed * GetFrameTime();
+        else if (strcmp(argv[i], "--synth") == 0) config.synth = true;
+        else if (strcmp(argv[i], "--particle-stress") == 0 && i + 1 < argc) config.particleStress = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--wall") == 0 && i + 1 < argc) config.wallMatches = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--asset-bench") == 0 && i + 1 < argc) config.assetBenchmark = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--exit-after-first-frame") == 0) config.exitAfterFirstFrame = true;
+        else if (strcmp(argv[i], "--stall-test") == 0 && i + 1 < argc) config.stallTest = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) config.benchmark = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) config.captureFile = argv[++i];
+        else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "raylib") == 0) config.backend = BACKEND_RAYLIB;
+            else if (strcmp(argv[i], "software") == 0) config.backend = BACKEND_SOFTWARE;
+            else if (strcmp(argv[i], "null") == 0) config.backend = BACKEND_NULL;
+            else if (strcmp(argv[i], "terminal") == 0) config.backend = BACKEND_TERMINAL;
+            else TraceLog(LOG_WARNING, "CONFIG: Unknown render backend %s", argv[i]);
         }
-        if (IsKeyDown(KEY_UP) && rightPaddle->rect.y > 0) {
-            rightPaddle->rect.y -= rightPaddle->speed * GetFrameTime();
+        else TraceLog(LOG_WARNING, "CONFIG: Unknown option %s", argv[i]);
+    }
+
+    if (config.targetFps < 0) config.targetFps = TARGET_FPS;
+
+    // The render modes decide vsync and the cap themselves, the refresh rate is known after InitWindow()
+    if (config.renderMode == RENDER_VSYNC) config.vsync = true;
+    else if (config.renderMode == RENDER_CAPPED) config.vsync = false;
+    else if (config.renderMode == RENDER_UNCAPPED) {
+        config.vsync = false;
+        config.targetFps = 0;
+    }
+    if (config.wallMatches > WALL_MAX_MATCHES) config.wallMatches = WALL_MAX_MATCHES;
+    if (config.particleStress > PARTICLE_CAPACITY) config.particleStress = PARTICLE_CAPACITY;
+    if (config.latencySamples <= 0 || config.latencySamples > LATENCY_MAX_SAMPLES) config.latencySamples = LATENCY_MAX_SAMPLES;
+    return config;
+}
+
+void ResolveRenderMode(Config *config) {
+    if (config->renderMode != RENDER_VSYNC) return;
+
+    // Pace to the refresh rate and let the buffer swap do the locking
+    config->targetFps = GetMonitorRefreshRate(GetCurrentMonitor());
+    if (config->targetFps <= 0) config->targetFps = TARGET_FPS;
+}
+
+bool IsStaticScene(const GameState *state) {
+    switch (state->currentScene) {
+        case MAIN_MENU:
+        case EXIT_WINDOW:
+        case GAME_OVER:
+            return true;
+        case GAME:
+            return state->isPaused;
+        default:
+            return false;
+    }
+}
+
+void BeginSchedulerFrame(FrameScheduler *scheduler) {
+    // Everything since the previous frame started, waiting included, belongs to its mode
+    double now = GetTime();
+    double elapsed = now - scheduler->frameStart;
+    scheduler->frameStart = now;
+
+    if (scheduler->mode == SCHEDULE_ACTIVE) return;
+    scheduler->idleTime += elapsed;
+    scheduler->idleFrames++;
+}
+
+bool UpdateFrameScheduler(FrameScheduler *scheduler, bool busy) {
+    bool background = !scheduler->headless && (IsWindowMinimized() || !IsWindowFocused());
+    bool suspend = background && !scheduler->background;
+    scheduler->background = background;
+
+    ScheduleMode mode = SCHEDULE_ACTIVE;
+    // A scene that moves is busy by itself, one that does not, static or not, can wait.
+    // Nothing wakes a hidden window, so headless idles by polling at the background rate.
+    if (!busy) mode = (background || scheduler->headless) ? SCHEDULE_BACKGROUND : SCHEDULE_WAIT_EVENTS;
+
+    // Entering the background pauses a running match, which then counts as a static scene
+    if (mode == scheduler->mode) return suspend;
+    scheduler->mode = mode;
+
+    // Any input (or focus/restore) event wakes EndDrawing() and the next frame switches back
+    if (mode == SCHEDULE_ACTIVE || scheduler->headless) DisableEventWaiting();
+    else EnableEventWaiting();
+
+    return suspend;
+}
+
+void WaitForNextFrame(const FramePacer *pacer, const FrameScheduler *scheduler, InputSampler *sampler, Simulation *sim) {
+    bool active = (scheduler->mode == SCHEDULE_ACTIVE);
+    bool vsync = IsWindowState(FLAG_VSYNC_HINT);
+
+    // Uncapped rendering only samples input once per frame, at its start
+    if (active && scheduler->targetFps == 0) return;
+
+    // Mouse motion over an unfocused window still produces events, so cap the wake-up rate
+    double period = 1.0 / ((scheduler->mode == SCHEDULE_BACKGROUND || scheduler->targetFps == 0) ? IDLE_TARGET_FPS : scheduler->targetFps);
+    double deadline = scheduler->frameStart + period;
+
+    // With vsync the buffer swap absorbs the rest of the frame; leave it some slack
+    // so the wait and the swap never add up to a missed vblank
+    if (vsync) deadline -= VSYNC_SLACK;
+
+    if (active && pacer->mode == PACING_LATE) {
+        // Start the frame just in time to finish before the predicted present, so the
+        // input it samples is as fresh as possible. Without vsync presents follow our own
+        // pacing, predicting from them would feed back into the deadline.
+        double interval = vsync ? fmax(period, pacer->presentInterval) : period;
+        deadline = pacer->lastPresent + interval - pacer->workTime - PACING_LATE_MARGIN;
+    }
+
+    // Sleep coarsely, then spin the last stretch: sleeps overshoot, spinning does not
+    double spinFrom = (active && pacer->mode != PACING_SLEEP) ? deadline - PACING_SPIN_WINDOW : deadline;
+
+    // Meanwhile poll every INPUT_SAMPLE_PERIOD, so a press is timestamped to the
+    // millisecond rather than to the frame. The idle modes just sleep.
+    double nextSample = 0.0;
+    for (double now = GetTime(); now < deadline; now = GetTime()) {
+        if (now < spinFrom) WaitTime(fmin(INPUT_SAMPLE_PERIOD, spinFrom - now));
+        if (!active || now < nextSample) continue;
+        PollInputEvents();
+        SampleInput(sampler, sim);
+        PlayGameEvents(&sim->sounds, &sim->events.queues[EVENT_CONSUMER_AUDIO]); // Sounds start within a sample period
+        nextSample = now + INPUT_SAMPLE_PERIOD;
+    }
+}
+
+void EndSchedulerFrame(FrameScheduler *scheduler) {
+    if (scheduler->mode != SCHEDULE_ACTIVE) return;
+    scheduler->activeWork += GetTime() - scheduler->frameStart;
+    scheduler->activeFrames++;
+}
+
+const char *GetPacingModeName(PacingMode mode) {
+    static const char *names[] = { "sleep", "hybrid", "late" };
+    return names[mode];
+}
+
+void EndFramePacing(FramePacer *pacer, const FrameScheduler *scheduler, double work) {
+    double now = GetTime();
+    double interval = now - pacer->lastPresent;
+    pacer->lastInterval = interval;
+    bool measured = (pacer->lastPresent > 0.0 && scheduler->mode == SCHEDULE_ACTIVE);
+    pacer->lastPresent = now;
+
+    // Idle frames wait on events, not on the pacer
+    if (!measured) return;
+
+    pacer->presentInterval += (interval - pacer->presentInterval) * PACING_SMOOTHING;
+    pacer->workTime += (work - pacer->workTime) * PACING_SMOOTHING;
+    pacer->activeTime += interval;
+    pacer->totalWork += work;
+
+    // Uncapped frames have no target, their jitter is measured around the average instead
+    double target = (scheduler->targetFps > 0) ? 1.0 / scheduler->targetFps : pacer->presentInterval;
+    int bin = (int)floor((interval - target) / JITTER_BIN_WIDTH) + JITTER_BINS / 2;
+    if (bin < 0) bin = 0;
+    else if (bin > JITTER_BINS - 1) bin = JITTER_BINS - 1;
+    pacer->histogram[bin]++;
+    pacer->frames++;
+}
+
+void LogFramePacing(const FramePacer *pacer, const FrameScheduler *scheduler, const Config *config) {
+    static const char *renderModes[] = { "default", "vsync", "capped", "uncapped" };
+    TraceLog(LOG_INFO, "PACING: %s, target %d fps, %d frames", GetPacingModeName(pacer->mode), scheduler->targetFps, pacer->frames);
+    if (pacer->frames == 0) return;
+
+    // Active frames only, so benchmarks of different cabinets and monitors compare like for like
+    TraceLog(LOG_INFO, "RENDER: mode %s, vsync %s, achieved %.1f fps, CPU work %.3f ms per frame",
+             renderModes[config->renderMode], config->vsync ? "on" : "off",
+             pacer->frames / pacer->activeTime, pacer->totalWork / pacer->frames * 1000.0);
+
+    for (int i = 0; i < JITTER_BINS; i++) {
+        float from = (i - JITTER_BINS / 2) * JITTER_BIN_WIDTH * 1000.0f;
+        const char *label = (i == 0) ? TextFormat("     < %+5.1f ms", from + JITTER_BIN_WIDTH * 1000.0f)
+                          : (i == JITTER_BINS - 1) ? TextFormat("    >= %+5.1f ms", from)
+                          : TextFormat("%+5.1f..%+5.1f ms", from, from + JITTER_BIN_WIDTH * 1000.0f);
+
+        char bar[51] = { 0 };
+        memset(bar, '#', (size_t)(50.0f * pacer->histogram[i] / pacer->frames));
+        TraceLog(LOG_INFO, "PACING: %s %6d %s", label, pacer->histogram[i], bar);
+    }
+}
+
+double GetSchedulerCpuSaved(const FrameScheduler *scheduler) {
+    if (scheduler->activeFrames == 0) return 0.0;
+
+    // Frames a full-rate loop would have produced while idle, priced at the measured active frame cost
+    int fps = (scheduler->targetFps > 0) ? scheduler->targetFps : TARGET_FPS;
+    double skippedFrames = scheduler->idleTime * fps - scheduler->idleFrames;
+    if (skippedFrames < 0.0) skippedFrames = 0.0;
+    return skippedFrames * (scheduler->activeWork / scheduler->activeFrames);
+}
+
+// Draw layers: the background, effects underneath the playfield shapes, and text on top
+enum { LAYER_BACKGROUND, LAYER_EFFECTS, LAYER_SHAPES, LAYER_TEXT };
+
+static void PushLabel(DrawList *list, int label, Vector2 position, int size, Color color) {
+    PushText(list, LAYER_TEXT, label, position, size, (float)(size / 10), color); // DrawText() spacing
+}
+
+static void PushScores(DrawList *list, Color color) {
+    PushLabel(list, LABEL_SCORE_LEFT, (Vector2){ playfieldWidth / 4, 20 }, 80, color);
+    PushLabel(list, LABEL_SCORE_RIGHT, (Vector2){ 3 * playfieldWidth / 4, 20 }, 80, color);
+}
+
+// One line per sample from the ball back TRAIL_TICKS of simulation time, fading
+// from TRAIL_ALPHA to nothing. Samples ahead of the interpolated ball are skipped
+// and the oldest line is cut where the trail's time runs out.
+static void PushBallTrail(DrawList *list, const BallTrail *trail, const Ball *ball) {
+    double duration = TRAIL_TICKS * SIM_DT;
+    double end = trail->time - duration;
+    Vector2 from = ball->position;
+    double fromTime = trail->time;
+
+    for (int i = 1; i <= trail->count && fromTime > end; i++) {
+        int sample = (trail->head + TRAIL_SAMPLES - i) % TRAIL_SAMPLES;
+        Vector2 to = trail->points[sample];
+        double toTime = trail->times[sample];
+        if (toTime >= fromTime) continue;
+        if (toTime < end) {
+            to = Vector2Lerp(from, to, (float)((fromTime - end) / (fromTime - toTime)));
+            toTime = end;
         }
-        if (IsKeyDown(KEY_DOWN) && rightPaddle->rect.y < screenHeight - PADDLE_HEIGHT) {
-            rightPaddle->rect.y += rightPaddle->speed * GetFrameTime();
+
+        Color fromColor = Fade(RAYWHITE, TRAIL_ALPHA * (float)((fromTime - end) / duration));
+        Color toColor = Fade(RAYWHITE, TRAIL_ALPHA * (float)((toTime - end) / duration));
+        PushLine(list, LAYER_EFFECTS, from, to, BALL_SIZE, fromColor, toColor);
+        from = to;
+        fromTime = toTime;
+    }
+}
+
+static void PushPaddles(DrawList *list, const Paddle *left, const Paddle *right, Color color) {
+    PushRect(list, LAYER_SHAPES, left->rect, color);
+    PushRect(list, LAYER_SHAPES, right->rect, color);
+}
+
+void BuildScene(DrawList *list, const TextCache *text, const Paddle *left, const Paddle *right, const Ball *ball, const GameState *state,
+                const BallTrail *trail, struct ParticleSystem *particles) {
+    BeginDrawList(list, text->labels);
+    PushClear(list, DARKGRAY);
+    PushParticles(list, LAYER_EFFECTS, particles); // Sparks outlive the scene that spawned them
+
+    switch (state->currentScene) {
+        case EXIT_WINDOW:
+            PushLabel(list, LABEL_EXIT_PROMPT, text->exitPrompt, 30, RAYWHITE);
+            break;
+        case MAIN_MENU:
+            PushText(list, LAYER_TEXT, LABEL_TITLE, text->title, 40, MENU_SPACING, RAYWHITE);
+            PushText(list, LAYER_TEXT, LABEL_MENU_AI, text->menuAi, 20, MENU_SPACING, RAYWHITE);
+            PushText(list, LAYER_TEXT, LABEL_MENU_LOCAL, text->menuLocal, 20, MENU_SPACING, RAYWHITE);
+            PushText(list, LAYER_TEXT, LABEL_MENU_EXIT, text->menuExit, 20, MENU_SPACING, RAYWHITE);
+            break;
+        case PREGAME:
+            PushPaddles(list, left, right, LIGHTGRAY);
+            PushPlayfield(list, LAYER_SHAPES, LIGHTGRAY);
+            PushScores(list, LIGHTGRAY);
+            PushLabel(list, LABEL_PRESS_START, (Vector2){ (playfieldWidth / 2) - (playfieldWidth / 4), playfieldHeight / 3 }, 60, RAYWHITE);
+            break;
+        case GAME:
+            if (state->isPaused) {
+                PushPaddles(list, left, right, LIGHTGRAY);
+                PushPlayfield(list, LAYER_SHAPES, LIGHTGRAY);
+                PushLabel(list, LABEL_PAUSED, text->paused, 60, RED);
+                break;
+            }
+            PushPaddles(list, left, right, RAYWHITE);
+            if (trail != NULL) PushBallTrail(list, trail, ball);
+            PushCircle(list, LAYER_SHAPES, ball->position, BALL_SIZE / 2, RAYWHITE);
+            PushPlayfield(list, LAYER_SHAPES, RAYWHITE);
+            PushScores(list, RAYWHITE);
+            break;
+        case GAME_OVER:
+            PushPaddles(list, left, right, LIGHTGRAY);
+            PushPlayfield(list, LAYER_SHAPES, LIGHTGRAY);
+            PushScores(list, LIGHTGRAY);
+            PushLabel(list, LABEL_RESTART, (Vector2){ (playfieldWidth / 2) - (playfieldWidth / 4), playfieldHeight / 2 }, 60, RAYWHITE);
+            break;
+        case LATENCY_TEST:
+            PushRect(list, LAYER_SHAPES, right->rect, RAYWHITE);
+            PushPlayfield(list, LAYER_SHAPES, LIGHTGRAY);
+            break;
+        default: break;
+    }
+
+    SortDrawList(list);
+}
+
+void DrawScene(const Renderer *renderer) {
+    const DrawList *list = &renderer->commands;
+    Font font = GetFontDefault();
+
+    for (int i = 0; i < list->count; i++) {
+        const DrawCommand *command = &list->commands[i];
+        Rectangle b = command->bounds;
+
+        switch (command->type) {
+            case DRAW_CLEAR: ClearBackground(command->color); break;
+            case DRAW_RECT: DrawRectangleRec(b, command->color); break;
+            case DRAW_CIRCLE: DrawCircleV((Vector2){ b.x, b.y }, b.width, command->color); break;
+            case DRAW_LINE: DrawLineGradientEx((Vector2){ b.x, b.y }, (Vector2){ b.width, b.height }, command->thick, command->color, command->endColor); break;
+            case DRAW_PARTICLES: DrawParticles(list->particles); break;
+            case DRAW_PLAYFIELD: DrawPlayfieldLayer(&renderer->playfield, command->color); break;
+            case DRAW_TEXT:
+                DrawTextEx(font, list->labels[command->label], (Vector2){ b.x, b.y }, command->size, b.width, command->color);
+                break;
+            default: break;
         }
     }
+}
 
-    // Update ball position
-    ball->position.x += ball->direction.x * ball->speed * GetFrameTime();
-    ball->position.y += ball->direction.y * ball->speed * GetFrameTime();
+void RenderScene(Renderer *renderer, const GameState *state, bool retained) {
+    switch (renderer->backend) {
+        case BACKEND_RAYLIB:
+            if (retained) {
+                UpdateSceneCache(renderer, state);
+                DrawSceneCache(&renderer->scene, &renderer->layout);
+                break;
+            }
 
-    // Ball collision with top and bottom
-    if (ball->position.y <= 0 || ball->position.y >= screenHeight - BALL_SIZE) {
-        ball->direction.y *= -1; // Reverse Y direction
-        PlaySound(state->sounds.top);
+            // Whatever happens until the next static scene, scores or paddles may have
+            // moved, so its cached picture cannot be reused even for the same scene
+            renderer->scene.valid = false;
+            if (renderer->resolution.scale < 1.0f) DrawSceneScaled(renderer);
+            else {
+                BeginMode2D(renderer->layout.camera);
+                DrawScene(renderer);
+                EndMode2D();
+            }
+            break;
+        case BACKEND_SOFTWARE:
+            DrawSceneSoftware(renderer);
+            break;
+        case BACKEND_NULL:
+            ClearBackground(BLACK); // The commands were built, that is all that gets measured
+            break;
+        case BACKEND_TERMINAL:
+            ClearBackground(BLACK);
+            DrawTerminal(renderer->terminal, &renderer->commands);
+            break;
     }
+}
+
+void UpdateSceneCache(Renderer *renderer, const GameState *state) {
+    SceneCache *cache = &renderer->scene;
+    const ViewLayout *layout = &renderer->layout;
+    EnsureRenderTarget(&cache->texture, layout->windowWidth, layout->windowHeight);
+
+    if (cache->valid && cache->scene == state->currentScene && cache->isPaused == state->isPaused
+        && cache->windowWidth == layout->windowWidth && cache->windowHeight == layout->windowHeight) return;
+
+    BeginTextureMode(cache->texture);
+    BeginMode2D(layout->camera);
+    DrawScene(renderer);
+    EndMode2D();
+    EndTextureMode();
+
+    cache->valid = true;
+    cache->scene = state->currentScene;
+    cache->isPaused = state->isPaused;
+    cache->windowWidth = layout->windowWidth;
+    cache->windowHeight = layout->windowHeight;
+}
+
+// Top-left width x height corner of a render target. Texture rows run bottom-up,
+// hence the source starts at the far end and has a negative height.
+static Rectangle GetTargetRegion(RenderTexture2D target, float width, float height) {
+    return (Rectangle){ 0, target.texture.height - height, width, -height };
+}
+
+// Copies the target's pixels instead of blending them in. Its colors are final, but
+// translucent shapes drawn into it also blended its alpha below 255, and blending on
+// that alpha would let whatever the back buffer held before show through.
+static void DrawTargetOpaque(RenderTexture2D target, Rectangle source, Rectangle dest) {
+    rlSetBlendFactors(RL_ONE, RL_ZERO, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM);
+    DrawTexturePro(target.texture, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+    EndBlendMode();
+}
+
+void DrawSceneCache(const SceneCache *cache, const ViewLayout *layout) {
+    Rectangle source = GetTargetRegion(cache->texture, layout->windowWidth, layout->windowHeight);
+    DrawTargetOpaque(cache->texture, source, (Rectangle){ 0, 0, layout->windowWidth, layout->windowHeight });
+}
+
+void DrawSceneScaled(Renderer *renderer) {
+    DynamicResolution *resolution = &renderer->resolution;
+    const ViewLayout *layout = &renderer->layout;
+    EnsureRenderTarget(&resolution->target, layout->windowWidth, layout->windowHeight);
+
+    // The layout transform, shrunk by the resolution scale
+    Camera2D camera = layout->camera;
+    camera.offset = Vector2Scale(camera.offset, resolution->scale);
+    camera.zoom *= resolution->scale;
+
+    BeginTextureMode(resolution->target);
+    BeginMode2D(camera);
+    DrawScene(renderer);
+    EndMode2D();
+    EndTextureMode();
+
+    Rectangle source = GetTargetRegion(resolution->target, layout->windowWidth * resolution->scale, layout->windowHeight * resolution->scale);
+    DrawTargetOpaque(resolution->target, source, (Rectangle){ 0, 0, layout->windowWidth, layout->windowHeight });
+}
+
+void DrawSceneSoftware(Renderer *renderer) {
+    const DrawList *list = &renderer->commands;
+    const ViewLayout *layout = &renderer->layout;
+    RasterizeDrawList(list, &renderer->canvas, true);
+    UpdateTexture(renderer->canvasTexture, renderer->canvas.data);
+
+    // The canvas covers the playfield only, the letterbox takes the scene's clear color
+    if (list->count > 0 && list->commands[0].type == DRAW_CLEAR) ClearBackground(list->commands[0].color);
+
+    Rectangle source = { 0, 0, renderer->canvas.width, renderer->canvas.height };
+    Rectangle dest = { layout->camera.offset.x, layout->camera.offset.y, playfieldWidth * layout->scale, playfieldHeight * layout->scale };
+    DrawTexturePro(renderer->canvasTexture, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+}
+
+void UpdateBallTrail(BallTrail *trail, const Ball *ball, const GameState *state, double tickTime, double viewTime) {
+    trail->time = viewTime;
 
-    // Ball collision with paddles
-    if (CheckCollisionCircleRec(ball->position, BALL_SIZE / 2, leftPaddle->rect) || 
-        CheckCollisionCircleRec(ball->position, BALL_SIZE / 2, rightPaddle->rect)) {
-        ball->direction.x *= -1; // Reverse X direction
-        ball->speed += BALL_SPEED / 10.0;
-        PlaySound(state->sounds.hit);
+    // Only a ball in play leaves a trail, and a reset teleports it, so start over
+    if (state->currentScene != GAME || state->isPaused || ball->resets != trail->resets) {
+        trail->count = 0;
+        trail->resets = ball->resets;
+        if (state->currentScene != GAME || state->isPaused) return;
     }
 
-    // Scoring
-    if (ball->position.x < 0) {
-        PlaySound(state->sounds.edge);
-        state->rightScore++; // Right player scores
-        ResetBall(ball);
+    // One sample per tick the renderer sees. Ticks it skips, when frames are slower
+    // than the simulation, fall on the straight line between their neighbors.
+    if (trail->count > 0 && trail->times[(trail->head + TRAIL_SAMPLES - 1) % TRAIL_SAMPLES] >= tickTime) return;
+
+    trail->points[trail->head] = ball->position;
+    trail->times[trail->head] = tickTime;
+    trail->head = (trail->head + 1) % TRAIL_SAMPLES;
+    if (trail->count < TRAIL_SAMPLES) trail->count++;
+}
+
+void UpdateDynamicResolution(DynamicResolution *resolution, double interval, double budget) {
+    // GPU time hides inside the buffer swap and, with vsync, behind the wait for
+    // the vblank, so the controller watches present intervals: a frame over budget
+    // shows up as a late or missed present
+    resolution->presentInterval += (interval - resolution->presentInterval) * PACING_SMOOTHING;
+    resolution->frames++;
+    bool inBudget = (interval <= budget * RESOLUTION_OVER_BUDGET);
+    if (inBudget) resolution->framesInBudget++;
+    resolution->stableFrames = inBudget ? resolution->stableFrames + 1 : 0;
+
+    // Counted with the controller off too, so a fixed resolution can be compared
+    if (!resolution->enabled) return;
+    if (resolution->cooldown > 0) {
+        resolution->cooldown--;
+        return;
     }
-    if (ball->position.x > screenWidth) {
-        PlaySound(state->sounds.edge);
-        state->leftScore++;  // Left player scores
-        ResetBall(ball);
+
+    float scale = resolution->scale;
+    if (resolution->presentInterval > budget * RESOLUTION_OVER_BUDGET && scale > RESOLUTION_MIN_SCALE) {
+        // A step up that did not hold makes the next attempt wait twice as long
+        if (resolution->probing) resolution->probeFrames = (int)fmin(resolution->probeFrames * 2, RESOLUTION_MAX_PROBE_FRAMES);
+        resolution->probing = false;
+        scale = fmaxf(scale - RESOLUTION_STEP, RESOLUTION_MIN_SCALE);
+    }
+    else if (resolution->stableFrames >= resolution->probeFrames && scale < 1.0f) {
+        // Headroom is invisible while presents are on time, so probe for it
+        resolution->probing = true;
+        scale = fminf(scale + RESOLUTION_STEP, 1.0f);
     }
+    else return;
+
+    TraceLog(LOG_INFO, "RESOLUTION: presents every %.2f ms against a %.2f ms budget, scale %.1f -> %.1f",
+             resolution->presentInterval * 1000.0, budget * 1000.0, resolution->scale, scale);
+    resolution->scale = scale;
+    resolution->stableFrames = 0;
+    resolution->cooldown = RESOLUTION_COOLDOWN;
+}
 
-    if (state->leftScore == WIN_SCORE or state->rightScore == WIN_SCORE)
-        state->currentScene = GAME_OVER;
+void UpdateLatencyProbe(LatencyProbe *probe, float paddleY, unsigned int presses, double pressTime) {
+    // A newer press supersedes one that has not shown up yet
+    if (presses != probe->presses) {
+        probe->presses = presses;
+        probe->pressTime = pressTime;
+    }
 
-    // TraceLog(LOG_DEBUG, "After Update: x: %f, y: %f", ball->direction.x, ball->direction.y);
+    probe->tagged = (probe->pressTime > 0.0 && paddleY != probe->paddleY);
+    probe->paddleY = paddleY;
 }
 
-void ResetBall(Ball *ball) {
-    ball->position = (Vector2){(int)(screenWidth / 2),(int)( screenHeight / 2)};
-    ball->direction.x = (GetRandomValue(0, 1) == 0) ? 1.0f : -1.0f; // Randomize initial direction
-    ball->direction.y = (GetRandomValue(-1, 1) < 0) ? 1.0f : -1.0f; // Randomize initial vertical direction
-    ball->speed = BALL_SPEED;
+void EndLatencyProbeFrame(LatencyProbe *probe) {
+    if (!probe->tagged) return;
+
+    // EndDrawing() has returned, the frame showing the movement has been handed to the display
+    if (probe->count < LATENCY_MAX_SAMPLES) probe->samples[probe->count++] = GetTime() - probe->pressTime;
+    probe->pressTime = 0.0;
+    probe->tagged = false;
 }
 
-void DrawDashedLine(Color color) {
-    Vector2 start = { (int)(screenWidth / 2), 0 };
-    Vector2 end = { (int)(screenWidth / 2), screenHeight };
-    float dashLength = 10.0f;
-    float gapLength = 5.0f;
-    Vector2 direction = Vector2Subtract(end, start);
-    float length = Vector2Length(direction);
-    direction = Vector2Normalize(direction);
+void DrawLatencyProbe(const LatencyProbe *probe) {
+    double last = (probe->count > 0) ? probe->samples[probe->count - 1] : 0.0;
+    DrawText(TextFormat("Latency test: %d samples, last %.1f ms (press Up/Down or wait for synthetic presses)",
+             probe->count, last * 1000.0), 20, 20, 20, RAYWHITE);
+}
 
-    float totalLength = 0.0f;
-    while (totalLength < length) {
-        // Calculate the start and end points of the dash
-        Vector2 dashStart = Vector2Add(start, Vector2Scale(direction, totalLength));
-        Vector2 dashEnd = Vector2Add(dashStart, Vector2Scale(direction, dashLength));
+static int CompareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
 
-        // Draw the dash
-        DrawLineEx(dashStart, dashEnd, 5, color);
+void WriteLatencyReport(const LatencyProbe *probe, const Config *config) {
+    if (probe->count == 0) return;
 
-        // Move the total length by the dash length and gap length
-        totalLength += dashLength + gapLength;
+    double sorted[LATENCY_MAX_SAMPLES];
+    memcpy(sorted, probe->samples, probe->count * sizeof(double));
+    qsort(sorted, probe->count, sizeof(double), CompareDoubles);
+
+    #define PERCENTILE(p) (sorted[(int)((p) * (probe->count - 1))] * 1000.0)
+    const char *line = TextFormat("vsync=%s msaa=%s fps=%d pacing=%s samples=%d min=%.2f p50=%.2f p90=%.2f p99=%.2f max=%.2f ms",
+                                  config->vsync ? "on" : "off", config->msaa ? "on" : "off", config->targetFps, GetPacingModeName(config->pacing), probe->count,
+                                  PERCENTILE(0.0), PERCENTILE(0.5), PERCENTILE(0.9), PERCENTILE(0.99), PERCENTILE(1.0));
+    #undef PERCENTILE
+
+    TraceLog(LOG_INFO, "LATENCY: %s", line);
+
+    // One line per run, so runs with different options can be compared side by side
+    FILE *file = fopen(TextFormat("%s%s", GetApplicationDirectory(), LATENCY_REPORT_FILE), "a");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "LATENCY: Failed to open %s", LATENCY_REPORT_FILE);
+        return;
     }
+    fprintf(file, "%s\n", line);
+    fclose(file);
 }
@@ -1,16 +1,69 @@
+#ifndef GAME_H
+#define GAME_H
+
 #include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <iso646.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 
 #include "raylib.h"
 #include "raymath.h"
 #include "resource_dir.h"
+#include "render.h"
+#include "terminal.h"
+
+// #define DEV_MODE
 
 #define PADDLE_WIDTH 15
 #define PADDLE_HEIGHT 150
 #define BALL_SIZE 18
 #define BALL_SPEED 400.0f
 #define WIN_SCORE 10
+#define TARGET_FPS 60 // Default, see Config
+#define IDLE_TARGET_FPS 10
+#define VSYNC_SLACK 0.002
+#define PACING_SPIN_WINDOW 0.002        // Final stretch before a deadline is spun, sleeps overshoot by about a millisecond
+#define PACING_LATE_MARGIN 0.001        // Safety margin when rendering as late as possible
+#define PACING_SMOOTHING 0.1f           // Weight of the newest frame in the moving averages
+#define JITTER_BINS 18
+#define JITTER_BIN_WIDTH 0.0005         // Seconds per histogram bin, centered on the target period
+#define RESOLUTION_MIN_SCALE 0.5f
+#define RESOLUTION_STEP 0.1f
+#define RESOLUTION_COOLDOWN 30          // Frames to let a scale change settle before judging it
+#define RESOLUTION_OVER_BUDGET 1.05     // Scale down when presents average this share of the budget
+#define RESOLUTION_PROBE_FRAMES 120     // Frames within budget before trying the next scale up
+#define RESOLUTION_MAX_PROBE_FRAMES 1920
+#define LATENCY_MAX_SAMPLES 1024
+#define LATENCY_SYNTHETIC_PERIOD 0.2    // Seconds between synthetic presses, plus up to 50 ms jitter
+#define LATENCY_SYNTHETIC_HOLD 0.08
+#define LATENCY_REPORT_FILE "latency_report.txt"
+
+#define GOLDEN_WIDTH 640                // Golden images are rendered at half the playfield size
+#define GOLDEN_HEIGHT 360
+#define GOLDEN_REPEATS 200              // Renders per scene, timed as the throughput benchmark
+#define GOLDEN_PIXEL_TOLERANCE 12       // Perceptual difference a pixel may have before it counts
+#define GOLDEN_MAX_DIFF_RATIO 0.002     // Share of pixels that may differ, for edge and glyph wiggle
+
+#define TRAIL_TICKS 32                  // Simulation ticks of ball movement the motion trail covers
+#define TRAIL_SAMPLES (TRAIL_TICKS + 4) // Plus the ticks the interpolated view lags behind the newest one
+#define TRAIL_ALPHA 0.5f                // Opacity of the trail next to the ball, fading to 0 at its end
+
+#define SOUND_VOICES 4                  // Overlapping plays per sound effect
+#define SOUND_RATE_LIMIT 0.03           // Seconds before the same effect may start again
+
+#define WALL_MAX_MATCHES 256
+#define WALL_TILE_FILL 0.96f            // Share of a grid cell a match covers, the rest is the gap
+#define DASH_LENGTH 10.0f
+#define DASH_GAP 5.0f
+#define DASH_THICKNESS 5
+
+#define TEXT_EXIT_PROMPT "Are you sure you want to exit program? [Y/N]"
+#define TEXT_MENU_ALIGN "Play with AI (press 1)" // Menu entries share this left edge
+#define MENU_SPACING 2.0f
 
 typedef struct Paddle {
     Rectangle rect;
@@ -21,12 +74,35 @@ typedef struct Ball {
     Vector2 position;
     Vector2 direction;
     float speed;
+    unsigned int resets;    // Bumped by ResetBall() so the renderer never interpolates across the jump
 } Ball;
 
+typedef enum {
+    SOUND_TOP,          // Ball off the top or bottom wall
+    SOUND_EDGE,         // Goal
+    SOUND_HIT,          // Paddle hit
+    SOUND_COUNT
+} SoundEffect;
+
+// A few voices of one sample: the first owns the wave data, the others are
+// aliases of it, so a new play never cuts off the one still ringing
+typedef struct {
+    Sound voices[SOUND_VOICES];
+    double started[SOUND_VOICES];
+    double lastStart;               // Event time of the latest start, for rate limiting
+    unsigned int played;
+    unsigned int stolen;            // Plays that cut off a busy voice
+    unsigned int limited;           // Plays skipped for coming too soon after the last
+} SoundPool;
+
+typedef struct Synth Synth;
+
+// Either loaded samples, or a synth making the tones when --synth is on. Loaded
+// on a background thread, nothing but ready may be touched before ready is set.
 typedef struct {
-    Sound hit;
-    Sound edge;
-    Sound top;
+    SoundPool effects[SOUND_COUNT];
+    Synth *synth;
+    atomic_bool ready;
 } Sounds;
 
 typedef enum {
@@ -34,7 +110,8 @@ typedef enum {
     PREGAME,
     GAME,
     GAME_OVER,
-    EXIT_WINDOW
+    EXIT_WINDOW,
+    LATENCY_TEST    // Diagnostic: right paddle only, measures press-to-photon latency
 } Scene;
 
 typedef struct {
@@ -43,16 +120,235 @@ typedef struct {
     bool isPaused;
     Scene currentScene;
     Scene prevScene;
-    Sounds sounds;
     bool aiPlayer;
+    bool exitRequested;
 } GameState;
 
-const int screenWidth = 1280;
-const int screenHeight = 720;
+// Maps the logical playfield onto the window with one uniform scale, centered and
+// letterboxed. Recomputed only when the window size changes.
+typedef struct {
+    int windowWidth;
+    int windowHeight;
+    float scale;
+    Camera2D camera;
+} ViewLayout;
+
+// Static playfield elements (center line) baked once into a render texture at a
+// pixel scale at least as large as the window needs. Drawn white and tinted at
+// draw time, so only growing past the baked scale forces a rebuild.
+typedef struct {
+    RenderTexture2D texture;
+    float scale;
+} PlayfieldLayer;
+
+typedef struct {
+    int value;
+    char text[8];
+} ScoreText;
+
+// Strings the scenes draw, referenced from draw commands by index
+typedef enum {
+    LABEL_EXIT_PROMPT,
+    LABEL_TITLE,
+    LABEL_MENU_AI,
+    LABEL_MENU_LOCAL,
+    LABEL_MENU_EXIT,
+    LABEL_SCORE_LEFT,
+    LABEL_SCORE_RIGHT,
+    LABEL_PRESS_START,
+    LABEL_PAUSED,
+    LABEL_RESTART,
+    LABEL_COUNT
+} Label;
+
+// Text layout measured once in playfield coordinates and score strings formatted only
+// when the score changes, so steady-state frames do no MeasureText/TextFormat work.
+typedef struct {
+    bool measured;
+    Vector2 exitPrompt;
+    Vector2 title;
+    Vector2 menuAi;
+    Vector2 menuLocal;
+    Vector2 menuExit;
+    Vector2 paused;
+    ScoreText left;
+    ScoreText right;
+    const char *labels[LABEL_COUNT];
+} TextCache;
+
+// Retained copy of a static scene (menus, game over, pause), re-rendered only when
+// the scene, pause state or window size changes
+typedef struct {
+    RenderTexture2D texture;
+    bool valid;
+    Scene scene;
+    bool isPaused;
+    int windowWidth;
+    int windowHeight;
+} SceneCache;
+
+// Live scenes drop to a lower internal resolution when frames go over budget.
+// At full scale they are drawn straight to the (multisampled) backbuffer; below it,
+// into the top-left part of a render texture that is upscaled bilinearly. Render
+// textures have no MSAA, so scaling down also gives up MSAA.
+typedef struct {
+    bool enabled;
+    float scale;
+    int cooldown;               // Frames until the next adjustment may happen
+    double presentInterval;     // Moving average of the present intervals of live frames
+    int stableFrames;           // Consecutive frames within budget
+    int probeFrames;            // Stable frames required before scaling up, doubles after a failed step up
+    bool probing;               // The last change was a step up
+    int framesInBudget;
+    int frames;
+    RenderTexture2D target;
+} DynamicResolution;
+
+// Ring buffer of ball positions sampled at simulation ticks, newest at head - 1, so
+// the trail covers the same stretch of time at any frame rate
+typedef struct {
+    Vector2 points[TRAIL_SAMPLES];
+    double times[TRAIL_SAMPLES];
+    int head;
+    int count;
+    unsigned int resets;        // Ball.resets of the samples, a reset starts a new trail
+    double time;                // The moment the rendered view shows, the trail ends there
+} BallTrail;
+
+// Window-sized render targets are allocated once at monitor size and drawn into
+// their top-left corner, so resizing the window never reallocates them.
+// Scenes are emitted as a draw list each frame and replayed by the chosen backend.
+typedef struct {
+    RenderBackend backend;
+    DrawList commands;
+    Image canvas;               // BACKEND_SOFTWARE target, at playfield size
+    Texture2D canvasTexture;
+    TerminalRenderer *terminal; // BACKEND_TERMINAL only
+    ViewLayout layout;
+    PlayfieldLayer playfield;
+    TextCache text;
+    SceneCache scene;
+    DynamicResolution resolution;
+    BallTrail trail;
+} Renderer;
+
+typedef enum {
+    SCHEDULE_ACTIVE,        // Polling at the configured frame rate
+    SCHEDULE_WAIT_EVENTS,   // Nothing changing on screen, sleep until input
+    SCHEDULE_BACKGROUND     // Minimized, unfocused or headless and idle, sleep until input at IDLE_TARGET_FPS
+} ScheduleMode;
+
+// Adaptive frame scheduler for the main loop, with counters for the time spent idle
+typedef struct {
+    ScheduleMode mode;
+    int targetFps;
+    bool headless;          // Hidden window, never counts as being in the background and never waits for events
+    bool background;
+    double frameStart;
+    double activeWork;      // Update + draw time of full-rate frames
+    int activeFrames;
+    double idleTime;        // Wall time spent in the idle modes
+    int idleFrames;
+} FrameScheduler;
+
+typedef enum {
+    PACING_SLEEP,       // Sleep until the deadline
+    PACING_HYBRID,      // Sleep, then spin the final PACING_SPIN_WINDOW to hit the deadline
+    PACING_LATE         // Hybrid, with the frame started as late as the predicted present allows
+} PacingMode;
+
+typedef enum {
+    RENDER_DEFAULT,     // VSYNC hint plus a TARGET_FPS cap, or whatever --fps/--no-vsync ask for
+    RENDER_VSYNC,       // Locked to the monitor refresh rate
+    RENDER_CAPPED,      // No vsync, capped at --mode N frames per second
+    RENDER_UNCAPPED     // No vsync, no cap
+} RenderMode;
+
+// Startup options, see ParseConfig() for the command line flags
+typedef struct {
+    bool vsync;
+    bool msaa;
+    RenderMode renderMode;
+    int targetFps;          // 0 renders uncapped
+    PacingMode pacing;
+    bool dynamicResolution;
+    bool latencyTest;
+    int latencySamples;     // The latency test exits after collecting this many
+    RenderBackend backend;
+    const char *captureFile;    // Records every rendered frame when set
+    const char *goldenDir;      // Runs the golden image tests instead of the game when set
+    bool goldenUpdate;          // Writes the golden images instead of comparing against them
+    int wallMatches;            // Shows this many AI matches at once instead of the game when set
+    int particleStress;         // Particles kept alive at all times, for benchmarking
+    bool synth;                 // Synthesized sounds instead of the sound files
+    int assetBenchmark;         // Times this many asset loads through each path instead of the game when set
+    bool exitAfterFirstFrame;   // For startup benchmarks
+    int stallTest;              // Injects this many render stalls and checks the simulation kept its tick when set
+    int benchmark;              // Plays an AI-vs-AI match for this many seconds and exits when set
+} Config;
+
+// Measures when frames actually reach the display and predicts the next present
+typedef struct {
+    PacingMode mode;
+    double lastPresent;         // GetTime() when the previous EndDrawing() returned
+    double lastInterval;
+    double presentInterval;     // Moving average of measured present intervals
+    double workTime;            // Moving average of update + draw time before EndDrawing()
+    int histogram[JITTER_BINS]; // Present interval minus target period, outer bins hold the tails
+    int frames;
+    double activeTime;          // Sum of measured present intervals
+    double totalWork;
+} FramePacer;
+
+// Motion-to-photon probe: from the timestamp of a press to the return of the
+// EndDrawing() of the first frame that shows the paddle moving
+typedef struct {
+    unsigned int presses;   // Press counter of the last snapshot seen
+    double pressTime;       // Press waiting for visible movement, 0 when none
+    float paddleY;          // Paddle position drawn by the previous frame
+    bool tagged;            // The current frame is the first to show the movement
+    double samples[LATENCY_MAX_SAMPLES];
+    int count;
+} LatencyProbe;
+
+// Logical playfield size, mapped onto the window by ViewLayout
+static const int playfieldWidth = 1280;
+static const int playfieldHeight = 720;
+
+void TraceLogToStderr(int logLevel, const char *text, va_list args);
+void DrawDashedLine(Vector2 start, Vector2 end, float thick, Color color);
+void InitRenderer(Renderer *renderer, const Config *config);
+void UnloadRenderer(Renderer *renderer);
+void EnsureRenderTarget(RenderTexture2D *target, int width, int height);
+bool UpdateViewLayout(ViewLayout *layout);
+void UpdatePlayfieldLayer(PlayfieldLayer *layer, float scale);
+void DrawPlayfieldLayer(const PlayfieldLayer *layer, Color color);
+void UpdateTextCache(TextCache *cache, const GameState *state);
+Config ParseConfig(int argc, char **argv);
+void ResolveRenderMode(Config *config);
+bool IsStaticScene(const GameState *state);
+void BuildScene(DrawList *list, const TextCache *text, const Paddle *left, const Paddle *right, const Ball *ball, const GameState *state,
+                const BallTrail *trail, struct ParticleSystem *particles);
+void DrawScene(const Renderer *renderer);
+void RenderScene(Renderer *renderer, const GameState *state, bool retained);
+void UpdateSceneCache(Renderer *renderer, const GameState *state);
+void DrawSceneCache(const SceneCache *cache, const ViewLayout *layout);
+void DrawSceneScaled(Renderer *renderer);
+void DrawSceneSoftware(Renderer *renderer);
+void UpdateDynamicResolution(DynamicResolution *resolution, double interval, double budget);
+void UpdateBallTrail(BallTrail *trail, const Ball *ball, const GameState *state, double tickTime, double viewTime);
+void BeginSchedulerFrame(FrameScheduler *scheduler);
+bool UpdateFrameScheduler(FrameScheduler *scheduler, bool busy);
+void EndSchedulerFrame(FrameScheduler *scheduler);
+const char *GetPacingModeName(PacingMode mode);
+void EndFramePacing(FramePacer *pacer, const FrameScheduler *scheduler, double work);
+void LogFramePacing(const FramePacer *pacer, const FrameScheduler *scheduler, const Config *config);
+double GetSchedulerCpuSaved(const FrameScheduler *scheduler);
+void UpdateLatencyProbe(LatencyProbe *probe, float paddleY, unsigned int presses, double pressTime);
+void EndLatencyProbeFrame(LatencyProbe *probe);
+void DrawLatencyProbe(const LatencyProbe *probe);
+void WriteLatencyReport(const LatencyProbe *probe, const Config *config);
+int RunGoldenTests(const Config *config);
+int RunWallView(const Config *config);
 
-void GameLogic(Paddle *leftPaddle, Paddle *rightPaddle, Ball *ball, GameState *state);
-void ResetBall(Ball *ball);
-void DrawDashedLine(Color color);
-void DrawMainMenu();
-void DrawGame();
-void DrawGameOver();
+#endif // GAME_H
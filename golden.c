@@ -0,0 +1,168 @@
+#include "game.h"
+#include "sim.h"
+#include "particles.h"
+#include "startup.h"
+
+// One scene in a fixed state. Positions and scores are arbitrary but never change,
+// so a difference in the image is a difference in the rendering.
+typedef struct {
+    const char *name;
+    Scene scene;
+    bool paused;
+    bool trail;         // The ball came in along its direction at full speed
+    bool sparks;        // The left paddle was just hit
+} GoldenCase;
+
+static const GoldenCase goldenCases[] = {
+    { "main_menu", MAIN_MENU, false, false, false },
+    { "exit_window", EXIT_WINDOW, false, false, false },
+    { "pregame", PREGAME, false, false, false },
+    { "game", GAME, false, false, false },
+    { "game_paused", GAME, true, false, false },
+    { "game_over", GAME_OVER, false, false, false },
+    { "latency_test", LATENCY_TEST, false, false, false },
+    { "game_trail", GAME, false, true, false },
+    { "game_sparks", GAME, false, false, true },
+};
+
+// A trail of one sample per tick along the ball's path, ending at the ball
+static void BuildGoldenTrail(BallTrail *trail, const Ball *ball, const GameState *state) {
+    *trail = (BallTrail){ 0 };
+    for (int tick = -TRAIL_TICKS; tick <= 0; tick++) {
+        Ball sample = *ball;
+        sample.position = Vector2Add(ball->position, Vector2Scale(ball->direction, ball->speed * (float)(tick * SIM_DT)));
+        UpdateBallTrail(trail, &sample, state, tick * SIM_DT, 0.0);
+    }
+}
+
+// A paddle hit's burst a few frames in. The generator is seeded the same every
+// time, so the sparks always land on the same pixels.
+static void BuildGoldenSparks(ParticleSystem *particles, const Paddle *left) {
+    InitParticles(particles, 0);
+    EmitParticles(particles, (Vector2){ left->rect.x + left->rect.width, left->rect.y + left->rect.height / 2 }, PARTICLE_HIT_BURST, 400.0f);
+    for (int frame = 0; frame < 6; frame++) UpdateParticles(particles, 1.0f / TARGET_FPS);
+}
+
+// Luma difference plus half the chroma difference, so a slight shift in a color
+// counts for less than an edge that moved
+static int GetPixelDifference(Color a, Color b) {
+    int dr = a.r - b.r, dg = a.g - b.g, db = a.b - b.b;
+    int luma = (77 * dr + 150 * dg + 29 * db) / 256;
+    int blue = (-43 * dr - 85 * dg + 128 * db) / 256;
+    int red = (128 * dr - 107 * dg - 21 * db) / 256;
+    return abs(luma) + (abs(blue) + abs(red)) / 2;
+}
+
+// Pixels that differ beyond GOLDEN_PIXEL_TOLERANCE, -1 when the sizes disagree
+static int CompareGoldenImage(const Image *actual, const Image *golden) {
+    if (actual->width != golden->width || actual->height != golden->height) return -1;
+
+    const Color *a = actual->data;
+    const Color *b = golden->data;
+    int differing = 0;
+    for (int i = 0; i < actual->width * actual->height; i++)
+        if (GetPixelDifference(a[i], b[i]) > GOLDEN_PIXEL_TOLERANCE) differing++;
+    return differing;
+}
+
+// FNV-1a over the pixels, to catch two cases that render the same image
+static unsigned long long HashGoldenImage(const Image *image) {
+    const unsigned char *bytes = image->data;
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int i = 0; i < image->width * image->height * 4; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+int RunGoldenTests(const Config *config) {
+    // Everything is rasterized on the CPU; the hidden window only loads the default
+    // font, whose glyphs the text is drawn from. Headless machines need Xvfb.
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(GOLDEN_WIDTH, GOLDEN_HEIGHT, "Pong golden images");
+    Font font = GetFontDefault();
+    if (!IsWindowReady() || font.glyphs == NULL || font.glyphs[0].image.data == NULL) {
+        TraceLog(LOG_ERROR, "GOLDEN: no default font glyphs, the golden images need a display (try xvfb-run)");
+        if (IsWindowReady()) CloseWindow();
+        return 1;
+    }
+
+    DrawList list = { 0 };
+    InitArena(&list.arena, DRAW_ARENA_SIZE);
+    TextCache text = { .left.value = -1, .right.value = -1 };
+    Image canvas = GenImageColor(GOLDEN_WIDTH, GOLDEN_HEIGHT, BLANK);
+    if (config->goldenUpdate) MakeDirectory(config->goldenDir);
+
+    int caseCount = sizeof(goldenCases) / sizeof(goldenCases[0]);
+    unsigned long long hashes[sizeof(goldenCases) / sizeof(goldenCases[0])];
+    int failures = 0;
+    double renderTime = 0.0;
+    int maxDiffering = (int)(GOLDEN_WIDTH * GOLDEN_HEIGHT * GOLDEN_MAX_DIFF_RATIO);
+
+    for (int i = 0; i < caseCount; i++) {
+        const GoldenCase *golden = &goldenCases[i];
+        Paddle left = { { 50, 260, PADDLE_WIDTH, PADDLE_HEIGHT }, 500.0f };
+        Paddle right = { { playfieldWidth - 50 - PADDLE_WIDTH, 420, PADDLE_WIDTH, PADDLE_HEIGHT }, 500.0f };
+        Ball ball = { { 540, 300 }, { 0.8f, -0.6f }, BALL_SPEED, 0 };
+        GameState state = { .leftScore = 3, .rightScore = 7, .currentScene = golden->scene, .isPaused = golden->paused };
+        UpdateTextCache(&text, &state);
+
+        BallTrail trail = { 0 };
+        if (golden->trail) BuildGoldenTrail(&trail, &ball, &state);
+        ParticleSystem particles = { 0 };
+        if (golden->sparks) BuildGoldenSparks(&particles, &left);
+
+        // Rendered repeatedly, which doubles as the throughput benchmark
+        double start = GetStartupClock();
+        for (int repeat = 0; repeat < GOLDEN_REPEATS; repeat++) {
+            BuildScene(&list, &text, &left, &right, &ball, &state, &trail, golden->sparks ? &particles : NULL);
+            RasterizeDrawList(&list, &canvas, true);
+        }
+        renderTime += GetStartupClock() - start;
+        if (golden->sparks) UnloadParticles(&particles);
+
+        // Every case shows something the others do not; the same image twice means
+        // part of the scene went missing, and neither baseline would notice
+        hashes[i] = HashGoldenImage(&canvas);
+        int same = -1;
+        for (int j = 0; j < i && same < 0; j++) if (hashes[j] == hashes[i]) same = j;
+        if (same >= 0) {
+            TraceLog(LOG_WARNING, "GOLDEN: %s FAILED, renders the same image as %s", golden->name, goldenCases[same].name);
+            failures++;
+            continue;
+        }
+
+        const char *path = TextFormat("%s/%s.png", config->goldenDir, golden->name);
+        if (config->goldenUpdate) {
+            if (!ExportImage(canvas, path)) failures++;
+            continue;
+        }
+
+        if (!FileExists(path)) {
+            TraceLog(LOG_WARNING, "GOLDEN: %s missing, run with --golden-update to create it", golden->name);
+            failures++;
+            continue;
+        }
+
+        Image expected = LoadImage(path);
+        ImageFormat(&expected, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        int differing = CompareGoldenImage(&canvas, &expected);
+        UnloadImage(expected);
+
+        if (differing < 0 || differing > maxDiffering) {
+            // Keep the render next to the golden image for inspection
+            ExportImage(canvas, TextFormat("%s/%s.actual.png", config->goldenDir, golden->name));
+            TraceLog(LOG_WARNING, "GOLDEN: %s FAILED, %d pixels differ (%d allowed)", golden->name, differing, maxDiffering);
+            failures++;
+        }
+        else TraceLog(LOG_INFO, "GOLDEN: %s passed, %d pixels differ", golden->name, differing);
+    }
+
+    int frames = caseCount * GOLDEN_REPEATS;
+    TraceLog(LOG_INFO, "GOLDEN: %d of %d cases %s, %d frames at %dx%d in %.0f ms (%.0f frames/s)",
+             caseCount - failures, caseCount, config->goldenUpdate ? "written" : "passed",
+             frames, GOLDEN_WIDTH, GOLDEN_HEIGHT, renderTime * 1000.0, frames / renderTime);
+
+    UnloadImage(canvas);
+    FreeArena(&list.arena);
+    CloseWindow();
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+#!/bin/sh
+# Frame budget benchmark on software GL (Mesa llvmpipe) under a virtual framebuffer.
+#   ./llvmpipe_bench.sh [SECONDS] [game options...]
+# Plays a --benchmark match for SECONDS (default 30) once with dynamic resolution
+# and once at fixed full resolution, and prints for each the GL renderer, the scale
+# the controller settled on and how often it changed it, the share of live frames
+# within budget, and the average frame time and CPU work per frame.
+#
+# Needs Xvfb and Mesa. The game's own log of each run is kept in llvmpipe_*.log.
+
+set -e
+
+DURATION=${1:-30}
+[ $# -gt 0 ] && shift
+
+cd "$(dirname "$0")"
+GAME=./game
+[ -x "$GAME" ] || GAME=./game.exe
+
+Xvfb :98 -screen 0 1920x1080x24 -nolisten tcp >/dev/null 2>&1 &
+XVFB=$!
+export DISPLAY=:98
+export LIBGL_ALWAYS_SOFTWARE=1
+export GALLIUM_DRIVER=llvmpipe
+trap 'kill "$XVFB"' EXIT
+sleep 1
+
+printf "%-8s %-24s %6s %8s %10s %9s %9s\n" mode renderer scale changes in_budget frame_ms cpu_ms
+for mode in dynamic fixed; do
+    extra=
+    [ "$mode" = fixed ] && extra=--no-dynamic-resolution
+    log=llvmpipe_$mode.log
+    "$GAME" --benchmark "$DURATION" $extra "$@" >"$log" 2>&1 || echo "warning: $mode run exited non-zero" >&2
+
+    # Fields are found by the word before them, the log lines carry their own labels
+    awk -v mode="$mode" '
+        function after(word,    i) {
+            for (i = 1; i < NF; i++) if ($i == word) return $(i + 1)
+            return "-"
+        }
+        /GL: Renderer:/ { renderer = $0; sub(/.*Renderer: */, "", renderer) }
+        /RESOLUTION: presents every/ { changes++ }
+        /RESOLUTION: final scale/ {
+            scale = after("scale")
+            for (i = 1; i <= NF; i++) if ($i ~ /%$/) budget = $i
+        }
+        /RENDER: mode/ { fps = after("achieved"); cpu = after("work") }
+        END {
+            sub(/,$/, "", scale)
+            printf "%-8s %-24.24s %6s %8d %10s %9.3f %9s\n", mode, (renderer == "") ? "-" : renderer,
+                   (scale == "") ? "-" : scale, changes, (budget == "") ? "-" : budget,
+                   (fps > 0) ? 1000 / fps : 0, (cpu == "") ? "-" : cpu
+        }
+    ' "$log"
+done
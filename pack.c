@@ -0,0 +1,82 @@
+// Packs assets into a bundle the game maps at startup, see bundle.h
+//   pack OUTPUT DIR NAME...
+// reads each DIR/NAME and stores it under NAME.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bundle.h"
+
+static unsigned char *ReadAsset(const char *path, long *size) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+
+    unsigned char *data = NULL;
+    if (fseek(file, 0, SEEK_END) == 0 && (*size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc(*size + 1);
+        if (data != NULL && fread(data, 1, *size, file) != (size_t)*size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        fprintf(stderr, "usage: %s OUTPUT DIR NAME...\n", argv[0]);
+        return 1;
+    }
+
+    int count = argc - 3;
+    AssetBundleHeader header = { .count = (uint32_t)count };
+    memcpy(header.magic, ASSET_BUNDLE_MAGIC, sizeof(header.magic));
+    AssetEntry *entries = calloc(count, sizeof(AssetEntry));
+    unsigned char **data = calloc(count, sizeof(unsigned char *));
+
+    unsigned long offset = sizeof(AssetBundleHeader) + count * sizeof(AssetEntry);
+    for (int i = 0; i < count; i++) {
+        const char *name = argv[3 + i];
+        if (strlen(name) >= ASSET_NAME_SIZE) {
+            fprintf(stderr, "pack: name too long: %s\n", name);
+            return 1;
+        }
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", argv[2], name);
+        long size = 0;
+        data[i] = ReadAsset(path, &size);
+        if (data[i] == NULL) {
+            fprintf(stderr, "pack: cannot read %s\n", path);
+            return 1;
+        }
+
+        offset = (offset + ASSET_ALIGNMENT - 1) & ~(unsigned long)(ASSET_ALIGNMENT - 1);
+        strcpy(entries[i].name, name);
+        entries[i].offset = (uint32_t)offset;
+        entries[i].size = (uint32_t)size;
+        offset += size;
+    }
+
+    FILE *out = fopen(argv[1], "wb");
+    if (out == NULL) {
+        fprintf(stderr, "pack: cannot write %s\n", argv[1]);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, out);
+    fwrite(entries, sizeof(AssetEntry), count, out);
+    for (int i = 0; i < count; i++) {
+        static const unsigned char padding[ASSET_ALIGNMENT] = { 0 };
+        fwrite(padding, 1, entries[i].offset - ftell(out), out);
+        fwrite(data[i], 1, entries[i].size, out);
+        free(data[i]);
+    }
+    bool ok = (fclose(out) == 0);
+
+    printf("pack: %d assets, %lu bytes in %s\n", count, offset, argv[1]);
+    free(entries);
+    free(data);
+    return ok ? 0 : 1;
+}
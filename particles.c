@@ -0,0 +1,208 @@
+#include <stdint.h>
+
+#include "particles.h"
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define PARTICLES_SSE
+#endif
+
+// xorshift32, cheaper than GetRandomValue() for thousands of particles a frame
+static float RandomUnit(ParticleSystem *particles) {
+    unsigned int x = particles->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    particles->seed = x;
+    return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+void InitParticles(ParticleSystem *particles, int stress) {
+    *particles = (ParticleSystem){ .seed = 0x9e3779b9u, .stress = stress };
+
+    // One block for all five arrays, each 16-byte aligned for the SSE loads
+    size_t arraySize = PARTICLE_CAPACITY * sizeof(float);
+    particles->memory = malloc(5 * arraySize + 15);
+    float *base = (float *)(((uintptr_t)particles->memory + 15) & ~(uintptr_t)15);
+    particles->x = base;
+    particles->y = base + PARTICLE_CAPACITY;
+    particles->vx = base + 2 * PARTICLE_CAPACITY;
+    particles->vy = base + 3 * PARTICLE_CAPACITY;
+    particles->life = base + 4 * PARTICLE_CAPACITY;
+
+    particles->mesh = (Mesh){ .vertexCount = 3 * PARTICLE_CAPACITY, .triangleCount = PARTICLE_CAPACITY };
+    particles->mesh.vertices = MemAlloc(3 * PARTICLE_CAPACITY * 3 * sizeof(float));
+    particles->mesh.colors = MemAlloc(3 * PARTICLE_CAPACITY * 4);
+}
+
+void EmitParticles(ParticleSystem *particles, Vector2 position, int count, float speed) {
+    // A full pool drops the newest sparks rather than recycling live ones
+    if (count > PARTICLE_CAPACITY - particles->count) count = PARTICLE_CAPACITY - particles->count;
+
+    for (int i = particles->count; i < particles->count + count; i++) {
+        float angle = RandomUnit(particles) * 2.0f * PI;
+        float velocity = speed * (0.3f + 0.7f * RandomUnit(particles));
+        particles->x[i] = position.x;
+        particles->y[i] = position.y;
+        particles->vx[i] = cosf(angle) * velocity;
+        particles->vy[i] = sinf(angle) * velocity;
+        particles->life[i] = 0.4f + 0.6f * RandomUnit(particles);
+    }
+    particles->count += count;
+}
+
+void SpawnGameEffects(ParticleSystem *particles, GameEventQueue *events) {
+    GameEvent event;
+    while (PollGameEvent(events, &event)) {
+        if (event.type == EVENT_PADDLE_HIT) EmitParticles(particles, event.position, PARTICLE_HIT_BURST, 400.0f);
+        else if (event.type == EVENT_GOAL) EmitParticles(particles, event.position, PARTICLE_GOAL_BURST, 700.0f);
+    }
+
+    if (particles->stress > particles->count) {
+        EmitParticles(particles, (Vector2){ playfieldWidth / 2, playfieldHeight / 2 }, particles->stress - particles->count, 900.0f);
+    }
+}
+
+void UpdateParticles(ParticleSystem *particles, float dt) {
+    if (particles->count == 0) return;
+
+    double start = GetTime();
+    float drag = fmaxf(0.0f, 1.0f - PARTICLE_DRAG * dt);
+
+    // Integrate in blocks of four; the tail past count is scratch within the capacity
+    int blocks = (particles->count + 3) / 4;
+#ifdef PARTICLES_SSE
+    __m128 dt4 = _mm_set1_ps(dt);
+    __m128 drag4 = _mm_set1_ps(drag);
+    __m128 gravity4 = _mm_set1_ps(PARTICLE_GRAVITY * dt);
+    for (int b = 0; b < blocks; b++) {
+        int i = 4 * b;
+        __m128 vx = _mm_mul_ps(_mm_load_ps(particles->vx + i), drag4);
+        __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_load_ps(particles->vy + i), drag4), gravity4);
+        _mm_store_ps(particles->x + i, _mm_add_ps(_mm_load_ps(particles->x + i), _mm_mul_ps(vx, dt4)));
+        _mm_store_ps(particles->y + i, _mm_add_ps(_mm_load_ps(particles->y + i), _mm_mul_ps(vy, dt4)));
+        _mm_store_ps(particles->vx + i, vx);
+        _mm_store_ps(particles->vy + i, vy);
+        _mm_store_ps(particles->life + i, _mm_sub_ps(_mm_load_ps(particles->life + i), dt4));
+    }
+#else
+    for (int i = 0; i < 4 * blocks; i++) {
+        particles->vx[i] *= drag;
+        particles->vy[i] = particles->vy[i] * drag + PARTICLE_GRAVITY * dt;
+        particles->x[i] += particles->vx[i] * dt;
+        particles->y[i] += particles->vy[i] * dt;
+        particles->life[i] -= dt;
+    }
+#endif
+
+    // Keep the live ones packed: a dead particle takes the last live one's place
+    for (int i = 0; i < particles->count;) {
+        if (particles->life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --particles->count;
+        particles->x[i] = particles->x[last];
+        particles->y[i] = particles->y[last];
+        particles->vx[i] = particles->vx[last];
+        particles->vy[i] = particles->vy[last];
+        particles->life[i] = particles->life[last];
+    }
+
+    particles->updated += 4 * blocks;
+    particles->updateTime += GetTime() - start;
+    particles->frames++;
+}
+
+// Sparks cool from white to orange while they fade
+static Color GetSparkColor(float life) {
+    life = fminf(life, 1.0f);
+    return (Color){ 255, (unsigned char)(140 + 115 * life), (unsigned char)(60 + 195 * life), (unsigned char)(255 * life) };
+}
+
+void DrawParticles(ParticleSystem *particles) {
+    if (particles->count == 0) return;
+    if (!particles->uploaded) {
+        UploadMesh(&particles->mesh, true);
+        particles->material = LoadMaterialDefault();
+        particles->uploaded = true;
+    }
+
+    double start = GetTime();
+    float *vertices = particles->mesh.vertices;
+    unsigned char *colors = particles->mesh.colors;
+    for (int i = 0; i < particles->count; i++) {
+        float x = particles->x[i], y = particles->y[i];
+        float *v = vertices + 9 * i;
+
+        // Counter-clockwise on screen, the winding raylib's 2D triangles use
+        v[0] = x;                 v[1] = y - PARTICLE_SIZE; v[2] = 0.0f;
+        v[3] = x - PARTICLE_SIZE; v[4] = y + PARTICLE_SIZE; v[5] = 0.0f;
+        v[6] = x + PARTICLE_SIZE; v[7] = y + PARTICLE_SIZE; v[8] = 0.0f;
+
+        Color color = GetSparkColor(particles->life[i]);
+        for (int corner = 0; corner < 3; corner++) memcpy(colors + 12 * i + 4 * corner, &color, 4);
+    }
+
+    UpdateMeshBuffer(particles->mesh, 0, vertices, particles->count * 9 * sizeof(float), 0);
+    UpdateMeshBuffer(particles->mesh, 3, colors, particles->count * 12, 0);
+    particles->buildTime += GetTime() - start;
+
+    // Whatever the batch holds belongs underneath, DrawMesh() bypasses it
+    rlDrawRenderBatchActive();
+
+    // Only the live prefix of the buffers is drawn
+    Mesh live = particles->mesh;
+    live.vertexCount = 3 * particles->count;
+    live.triangleCount = particles->count;
+    DrawMesh(live, particles->material, MatrixIdentity());
+}
+
+void RasterizeParticles(const ParticleSystem *particles, Image *canvas, float scale) {
+    Color *pixels = canvas->data;
+    for (int i = 0; i < particles->count; i++) {
+        Color color = GetSparkColor(particles->life[i]);
+        float x = particles->x[i] * scale, apex = (particles->y[i] - PARTICLE_SIZE) * scale;
+        float size = PARTICLE_SIZE * scale;
+
+        // The same triangle as on the GPU: a point at the top, widening by half a
+        // pixel per row down to 2 * size at its base
+        int top = (int)fmaxf(0.0f, floorf(apex));
+        int bottom = (int)fminf(canvas->height - 1, ceilf(apex + 2 * size));
+        for (int y = top; y <= bottom; y++) {
+            float depth = y + 0.5f - apex;
+            if (depth < 0.0f || depth > 2 * size) continue;
+
+            float half = depth / 2;
+            int left = (int)fmaxf(0.0f, ceilf(x - half - 0.5f));
+            int right = (int)fminf(canvas->width - 1, floorf(x + half - 0.5f));
+            for (int px = left; px <= right; px++) BlendPixel(&pixels[y * canvas->width + px], color);
+        }
+    }
+}
+
+void LogParticles(const ParticleSystem *particles) {
+    if (particles->frames == 0) return;
+
+    TraceLog(LOG_INFO, "PARTICLES: update %.3f ms, build %.3f ms per frame, %.0f particles/ms through the %s kernel",
+             particles->updateTime / particles->frames * 1000.0, particles->buildTime / particles->frames * 1000.0,
+             particles->updated / (particles->updateTime * 1000.0),
+#ifdef PARTICLES_SSE
+             "SSE"
+#else
+             "scalar"
+#endif
+             );
+}
+
+void UnloadParticles(ParticleSystem *particles) {
+    if (particles->uploaded) {
+        UnloadMesh(particles->mesh); // Frees the vertex and color arrays too
+        UnloadMaterial(particles->material);
+    }
+    else {
+        MemFree(particles->mesh.vertices);
+        MemFree(particles->mesh.colors);
+    }
+    free(particles->memory);
+}
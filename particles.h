@@ -0,0 +1,49 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "sim.h"
+
+#define PARTICLE_CAPACITY 131072        // Multiple of 4, the kernel runs four particles per step
+#define PARTICLE_SIZE 3.0f              // Half the extent of a spark, in playfield units
+#define PARTICLE_DRAG 3.0f              // Fraction of velocity lost per second
+#define PARTICLE_GRAVITY 600.0f
+#define PARTICLE_HIT_BURST 48
+#define PARTICLE_GOAL_BURST 256
+
+// Fixed-capacity particle pool in structure-of-arrays layout, so the update
+// kernel streams through each attribute four floats at a time. All memory is
+// allocated up front; the GPU mesh the sparks are drawn from is uploaded on the
+// first draw, so the CPU backends never need it.
+typedef struct ParticleSystem {
+    void *memory;
+    float *x;
+    float *y;
+    float *vx;
+    float *vy;
+    float *life;                // Seconds left, a particle dies at 0
+    int count;                  // Live particles are packed into [0, count)
+    unsigned int seed;
+
+    // One triangle per spark, drawn with a single DrawMesh() call
+    Mesh mesh;
+    Material material;
+    bool uploaded;
+
+    // Benchmark
+    int stress;                 // Particles kept alive in stress mode, 0 when off
+    double updateTime;
+    double buildTime;
+    unsigned long long updated;
+    int frames;
+} ParticleSystem;
+
+void InitParticles(ParticleSystem *particles, int stress);
+void EmitParticles(ParticleSystem *particles, Vector2 position, int count, float speed);
+void SpawnGameEffects(ParticleSystem *particles, GameEventQueue *events);
+void UpdateParticles(ParticleSystem *particles, float dt);
+void DrawParticles(ParticleSystem *particles);
+void RasterizeParticles(const ParticleSystem *particles, Image *canvas, float scale);
+void LogParticles(const ParticleSystem *particles);
+void UnloadParticles(ParticleSystem *particles);
+
+#endif // PARTICLES_H
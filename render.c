@@ -0,0 +1,253 @@
+#include "game.h"
+#include "particles.h"
+
+void InitArena(Arena *arena, size_t capacity) {
+    *arena = (Arena){ .base = malloc(capacity), .capacity = capacity };
+    if (arena->base == NULL) arena->capacity = 0;
+}
+
+void *ArenaAlloc(Arena *arena, size_t size) {
+    size = (size + 7) & ~(size_t)7; // Keep every allocation 8-byte aligned
+    if (arena->used + size > arena->capacity) return NULL;
+
+    void *memory = arena->base + arena->used;
+    arena->used += size;
+    return memory;
+}
+
+void ResetArena(Arena *arena) {
+    arena->used = 0;
+}
+
+void FreeArena(Arena *arena) {
+    free(arena->base);
+    *arena = (Arena){ 0 };
+}
+
+void BeginDrawList(DrawList *list, const char *const *labels) {
+    ResetArena(&list->arena);
+    // One block for the frame's commands, the sorted copy takes the rest of the arena
+    list->commands = ArenaAlloc(&list->arena, DRAW_MAX_COMMANDS * sizeof(DrawCommand));
+    list->capacity = (list->commands != NULL) ? DRAW_MAX_COMMANDS : 0;
+    list->count = 0;
+    list->dropped = 0;
+    list->batches = 0;
+    list->labels = labels;
+    list->particles = NULL;
+}
+
+void PushDrawCommand(DrawList *list, DrawCommand command) {
+    if (list->count == list->capacity) {
+        list->dropped++;
+        return;
+    }
+    list->commands[list->count++] = command;
+}
+
+void PushClear(DrawList *list, Color color) {
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_CLEAR, .color = color });
+}
+
+void PushRect(DrawList *list, int layer, Rectangle rect, Color color) {
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_RECT, .layer = layer, .color = color, .bounds = rect });
+}
+
+void PushCircle(DrawList *list, int layer, Vector2 center, float radius, Color color) {
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_CIRCLE, .layer = layer, .color = color, .bounds = { center.x, center.y, radius, 0 } });
+}
+
+void PushLine(DrawList *list, int layer, Vector2 start, Vector2 end, float thick, Color startColor, Color endColor) {
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_LINE, .layer = layer, .thick = thick, .color = startColor, .endColor = endColor,
+                                         .bounds = { start.x, start.y, end.x, end.y } });
+}
+
+void PushParticles(DrawList *list, int layer, struct ParticleSystem *particles) {
+    if (particles == NULL || particles->count == 0) return;
+    list->particles = particles;
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_PARTICLES, .layer = layer });
+}
+
+void PushPlayfield(DrawList *list, int layer, Color color) {
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_PLAYFIELD, .layer = layer, .color = color });
+}
+
+void PushText(DrawList *list, int layer, int label, Vector2 position, int size, float spacing, Color color) {
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_TEXT, .layer = layer, .label = label, .size = size, .color = color,
+                                         .bounds = { position.x, position.y, spacing, 0 } });
+}
+
+void SortDrawList(DrawList *list) {
+    if (list->count == 0) return;
+
+    // Stable counting sort on (layer, type): a handful of keys, so it is one pass to
+    // count and one to scatter, and the emit order survives within each run
+    enum { KEYS = DRAW_LAYERS * DRAW_TYPE_COUNT };
+    int offsets[KEYS] = { 0 };
+    for (int i = 0; i < list->count; i++) {
+        const DrawCommand *command = &list->commands[i];
+        offsets[command->layer * DRAW_TYPE_COUNT + command->type]++;
+    }
+
+    int total = 0;
+    for (int key = 0; key < KEYS; key++) {
+        int count = offsets[key];
+        offsets[key] = total;
+        total += count;
+        if (count > 0 && key % DRAW_TYPE_COUNT != DRAW_CLEAR) list->batches++;
+    }
+
+    DrawCommand *sorted = ArenaAlloc(&list->arena, list->count * sizeof(DrawCommand));
+    if (sorted == NULL) return; // Still correct in emit order, just not batched
+
+    for (int i = 0; i < list->count; i++) {
+        const DrawCommand *command = &list->commands[i];
+        sorted[offsets[command->layer * DRAW_TYPE_COUNT + command->type]++] = *command;
+    }
+    list->commands = sorted;
+}
+
+const char *GetRenderBackendName(RenderBackend backend) {
+    static const char *names[] = { "raylib", "software", "null", "terminal" };
+    return names[backend];
+}
+
+void DrawLineGradientEx(Vector2 start, Vector2 end, float thick, Color startColor, Color endColor) {
+    Vector2 delta = Vector2Subtract(end, start);
+    float length = Vector2Length(delta);
+    if (length <= 0.0f) return;
+
+    // DrawLineEx() takes one color, so this is its quad with a color per corner.
+    // Screen counter-clockwise, the winding raylib does not cull.
+    Vector2 side = Vector2Scale((Vector2){ -delta.y, delta.x }, thick / 2 / length);
+    Vector2 corners[4] = { Vector2Subtract(start, side), Vector2Add(start, side), Vector2Subtract(end, side), Vector2Add(end, side) };
+    Color colors[4] = { startColor, startColor, endColor, endColor };
+    static const int triangles[6] = { 0, 1, 2, 2, 1, 3 };
+
+    rlBegin(RL_TRIANGLES);
+    for (int i = 0; i < 6; i++) {
+        Color color = colors[triangles[i]];
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        rlVertex2f(corners[triangles[i]].x, corners[triangles[i]].y);
+    }
+    rlEnd();
+}
+
+// Source-over, the Image routines overwrite the pixel instead
+void BlendPixel(Color *pixel, Color color) {
+    if (color.a == 255) {
+        *pixel = color;
+        return;
+    }
+    int alpha = color.a, inverse = 255 - color.a;
+    pixel->r = (unsigned char)((color.r * alpha + pixel->r * inverse + 127) / 255);
+    pixel->g = (unsigned char)((color.g * alpha + pixel->g * inverse + 127) / 255);
+    pixel->b = (unsigned char)((color.b * alpha + pixel->b * inverse + 127) / 255);
+    pixel->a = (unsigned char)(alpha + (pixel->a * inverse + 127) / 255);
+}
+
+// Covers the pixels whose centers lie within the line's quad and blends the color
+// interpolated along it, so translucent and gradient lines look as on the GPU
+static void RasterizeLine(Image *canvas, Vector2 start, Vector2 end, float thick, Color startColor, Color endColor) {
+    Vector2 delta = Vector2Subtract(end, start);
+    float lengthSquared = Vector2LengthSqr(delta);
+    if (lengthSquared <= 0.0f) return;
+
+    float half = thick / 2;
+    int left = (int)fmaxf(0.0f, floorf(fminf(start.x, end.x) - half));
+    int right = (int)fminf(canvas->width - 1, ceilf(fmaxf(start.x, end.x) + half));
+    int top = (int)fmaxf(0.0f, floorf(fminf(start.y, end.y) - half));
+    int bottom = (int)fminf(canvas->height - 1, ceilf(fmaxf(start.y, end.y) + half));
+    float halfSquared = half * half * lengthSquared;
+
+    Color *pixels = canvas->data;
+    for (int y = top; y <= bottom; y++) {
+        for (int x = left; x <= right; x++) {
+            Vector2 offset = { x + 0.5f - start.x, y + 0.5f - start.y };
+            float along = offset.x * delta.x + offset.y * delta.y;
+            float across = offset.x * delta.y - offset.y * delta.x;
+            if (along < 0.0f || along >= lengthSquared || across * across > halfSquared) continue; // Joined lines blend once
+            BlendPixel(&pixels[y * canvas->width + x], ColorLerp(startColor, endColor, along / lengthSquared));
+        }
+    }
+}
+
+// Pixels whose centers lie inside the rectangle
+static void RasterizeRect(Image *canvas, Rectangle rect, Color color) {
+    int left = (int)fmaxf(0.0f, ceilf(rect.x - 0.5f));
+    int right = (int)fminf(canvas->width, ceilf(rect.x + rect.width - 0.5f));
+    int top = (int)fmaxf(0.0f, ceilf(rect.y - 0.5f));
+    int bottom = (int)fminf(canvas->height, ceilf(rect.y + rect.height - 0.5f));
+
+    Color *pixels = canvas->data;
+    for (int y = top; y < bottom; y++)
+        for (int x = left; x < right; x++) BlendPixel(&pixels[y * canvas->width + x], color);
+}
+
+// Pixels whose centers lie within the radius
+static void RasterizeCircle(Image *canvas, Vector2 center, float radius, Color color) {
+    int top = (int)fmaxf(0.0f, floorf(center.y - radius));
+    int bottom = (int)fminf(canvas->height - 1, ceilf(center.y + radius));
+
+    Color *pixels = canvas->data;
+    for (int y = top; y <= bottom; y++) {
+        float dy = y + 0.5f - center.y;
+        if (dy * dy > radius * radius) continue;
+
+        float half = sqrtf(radius * radius - dy * dy);
+        int left = (int)fmaxf(0.0f, ceilf(center.x - half - 0.5f));
+        int right = (int)fminf(canvas->width - 1, floorf(center.x + half - 0.5f));
+        for (int x = left; x <= right; x++) BlendPixel(&pixels[y * canvas->width + x], color);
+    }
+}
+
+static void RasterizeDashedLine(Image *canvas, float scale, Color color) {
+    // Same dashes as DrawDashedLine() down the center, which are axis aligned rectangles here
+    float x = (playfieldWidth / 2 - DASH_THICKNESS / 2.0f) * scale;
+    for (float y = 0.0f; y < playfieldHeight; y += DASH_LENGTH + DASH_GAP) {
+        float length = fminf(DASH_LENGTH, playfieldHeight - y);
+        RasterizeRect(canvas, (Rectangle){ x, y * scale, DASH_THICKNESS * scale, length * scale }, color);
+    }
+}
+
+void RasterizeDrawList(const DrawList *list, Image *canvas, bool text) {
+    float scale = (float)canvas->width / playfieldWidth;
+
+    // Shapes are rasterized here, so their pixels do not change with raylib's Image
+    // routines. Text goes through ImageDrawTextEx(): the default font keeps its glyph
+    // images around once a window has loaded it.
+    Font font = GetFontDefault();
+    bool glyphs = text && (font.glyphs != NULL && font.glyphs[0].image.data != NULL);
+
+    for (int i = 0; i < list->count; i++) {
+        const DrawCommand *command = &list->commands[i];
+        Rectangle b = command->bounds;
+
+        switch (command->type) {
+            case DRAW_CLEAR:
+                for (int p = 0; p < canvas->width * canvas->height; p++) ((Color *)canvas->data)[p] = command->color;
+                break;
+            case DRAW_RECT:
+                RasterizeRect(canvas, (Rectangle){ b.x * scale, b.y * scale, b.width * scale, b.height * scale }, command->color);
+                break;
+            case DRAW_CIRCLE:
+                RasterizeCircle(canvas, (Vector2){ b.x * scale, b.y * scale }, b.width * scale, command->color);
+                break;
+            case DRAW_LINE:
+                RasterizeLine(canvas, (Vector2){ b.x * scale, b.y * scale }, (Vector2){ b.width * scale, b.height * scale },
+                              fmaxf(1.0f, command->thick * scale), command->color, command->endColor);
+                break;
+            case DRAW_PARTICLES:
+                RasterizeParticles(list->particles, canvas, scale);
+                break;
+            case DRAW_PLAYFIELD:
+                RasterizeDashedLine(canvas, scale, command->color);
+                break;
+            case DRAW_TEXT:
+                if (!glyphs) break;
+                ImageDrawTextEx(canvas, font, list->labels[command->label], (Vector2){ b.x * scale, b.y * scale },
+                                command->size * scale, b.width * scale, command->color);
+                break;
+            default: break;
+        }
+    }
+}
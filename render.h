@@ -0,0 +1,103 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "raylib.h"
+
+#define DRAW_ARENA_SIZE (64 * 1024)     // Per-frame command memory, a frame needs well under 1 KiB
+#define DRAW_MAX_COMMANDS 1024          // Per frame; with their sorted copy they fill the arena
+#define DRAW_LAYERS 4
+
+struct ParticleSystem;
+
+// Bump allocator reset once per frame; nothing in it outlives the frame
+typedef struct {
+    unsigned char *base;
+    size_t capacity;
+    size_t used;
+} Arena;
+
+// Primitive kinds, in the order they are replayed within a layer. The shapes share
+// raylib's default white texture, the playfield layer and text each bind their own.
+typedef enum {
+    DRAW_CLEAR,
+    DRAW_RECT,
+    DRAW_CIRCLE,
+    DRAW_LINE,
+    DRAW_PARTICLES,     // The whole particle system, one mesh on the GPU
+    DRAW_PLAYFIELD,     // The static playfield (center line), baked where the backend can
+    DRAW_TEXT,
+    DRAW_TYPE_COUNT
+} DrawType;
+
+// One primitive in playfield coordinates. The bounds are interpreted per type:
+// rect x/y/width/height, circle center x/y and radius in width, line start x/y and
+// end in width/height, text position x/y and spacing in width.
+typedef struct {
+    unsigned char type;
+    unsigned char layer;    // Painter's order; sorting only reorders within a layer
+    unsigned char label;    // DRAW_TEXT: index into the list's label table
+    unsigned char size;     // DRAW_TEXT: font size
+    Color color;
+    Color endColor;         // DRAW_LINE: color at the end, blended from color at the start
+    float thick;            // DRAW_LINE: thickness
+    Rectangle bounds;
+} DrawCommand;
+
+typedef struct {
+    Arena arena;
+    DrawCommand *commands;  // One block reserved from the arena per frame
+    int count;
+    int capacity;
+    int dropped;            // Commands lost to a full block
+    int batches;            // Runs of one primitive type left after sorting
+    const char *const *labels;
+    struct ParticleSystem *particles;   // DRAW_PARTICLES: the system to draw
+} DrawList;
+
+typedef enum {
+    BACKEND_RAYLIB,     // GPU through raylib, the default
+    BACKEND_SOFTWARE,   // CPU rasterizer into an Image, uploaded once per frame
+    BACKEND_NULL,       // Records commands and draws nothing, for benchmarks
+    BACKEND_TERMINAL    // ANSI half blocks on stdout, the window stays hidden
+} RenderBackend;
+
+// From rlgl.h, which is not among the vendored headers: draws the pending batch
+// now, for reads and draws that bypass it, immediate-mode vertices that join the
+// batch with a color each, and the factors BLEND_CUSTOM blends with
+#define RL_TRIANGLES 0x0004
+#define RL_ZERO 0
+#define RL_ONE 1
+#define RL_FUNC_ADD 0x8006
+void rlDrawRenderBatchActive(void);
+void rlSetBlendFactors(int glSrcFactor, int glDstFactor, int glEquation);
+void rlBegin(int mode);
+void rlEnd(void);
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+void rlVertex2f(float x, float y);
+
+void InitArena(Arena *arena, size_t capacity);
+void *ArenaAlloc(Arena *arena, size_t size);
+void ResetArena(Arena *arena);
+void FreeArena(Arena *arena);
+
+void BeginDrawList(DrawList *list, const char *const *labels);
+void PushDrawCommand(DrawList *list, DrawCommand command);
+void PushClear(DrawList *list, Color color);
+void PushRect(DrawList *list, int layer, Rectangle rect, Color color);
+void PushCircle(DrawList *list, int layer, Vector2 center, float radius, Color color);
+void PushLine(DrawList *list, int layer, Vector2 start, Vector2 end, float thick, Color startColor, Color endColor);
+void PushParticles(DrawList *list, int layer, struct ParticleSystem *particles);
+void PushPlayfield(DrawList *list, int layer, Color color);
+void PushText(DrawList *list, int layer, int label, Vector2 position, int size, float spacing, Color color);
+void SortDrawList(DrawList *list);
+
+const char *GetRenderBackendName(RenderBackend backend);
+void DrawLineGradientEx(Vector2 start, Vector2 end, float thick, Color startColor, Color endColor);
+void BlendPixel(Color *pixel, Color color);
+void RasterizeDrawList(const DrawList *list, Image *canvas, bool text);
+
+
+#endif // RENDER_H
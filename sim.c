@@ -0,0 +1,554 @@
+#include <ctype.h>
+
+#include "sim.h"
+
+static void PublishSnapshot(TripleBuffer *buffer, const GameSnapshot *snapshot) {
+    buffer->slots[buffer->back] = *snapshot;
+    buffer->back = atomic_exchange(&buffer->middle, buffer->back | TRIPLE_BUFFER_FRESH) & ~TRIPLE_BUFFER_FRESH;
+}
+
+bool ReadSnapshot(Simulation *sim, GameSnapshot *snapshot) {
+    TripleBuffer *buffer = &sim->snapshots;
+    if (!(atomic_load(&buffer->middle) & TRIPLE_BUFFER_FRESH)) return false;
+
+    buffer->front = atomic_exchange(&buffer->middle, buffer->front) & ~TRIPLE_BUFFER_FRESH;
+    *snapshot = buffer->slots[buffer->front];
+    return true;
+}
+
+// Whether the two snapshots draw differently. Ticks keep coming while nothing moves,
+// on the pregame screen or between latency test presses, and those are not activity.
+bool IsSnapshotChanged(const GameSnapshot *prev, const GameSnapshot *next) {
+    const GameState *a = &prev->state, *b = &next->state;
+    return prev->leftPaddle.rect.y != next->leftPaddle.rect.y || prev->rightPaddle.rect.y != next->rightPaddle.rect.y ||
+           prev->ball.position.x != next->ball.position.x || prev->ball.position.y != next->ball.position.y ||
+           a->leftScore != b->leftScore || a->rightScore != b->rightScore || a->isPaused != b->isPaused ||
+           a->currentScene != b->currentScene || a->exitRequested != b->exitRequested;
+}
+
+static void PushGameEvent(GameEvents *events, GameEvent event) {
+    if (events == NULL) return; // Headless matches, like the wall view's, have no consumers
+
+    event.tick = events->tick;
+    event.time = events->time;
+    for (int i = 0; i < EVENT_CONSUMER_COUNT; i++) {
+        GameEventQueue *queue = &events->queues[i];
+        unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        if (head - atomic_load(&queue->tail) == GAME_EVENT_QUEUE_SIZE) {
+            atomic_fetch_add(&queue->dropped, 1);
+            continue;
+        }
+        queue->events[head & (GAME_EVENT_QUEUE_SIZE - 1)] = event;
+        atomic_store(&queue->head, head + 1);
+    }
+}
+
+void EmitGameEvent(GameEvents *events, GameEventType type, Vector2 position) {
+    PushGameEvent(events, (GameEvent){ .type = type, .position = position });
+}
+
+bool PollGameEvent(GameEventQueue *queue, GameEvent *event) {
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    if (tail == atomic_load(&queue->head)) return false;
+
+    *event = queue->events[tail & (GAME_EVENT_QUEUE_SIZE - 1)];
+    atomic_store(&queue->tail, tail + 1);
+    return true;
+}
+
+void UpdateEventStats(EventStats *stats, GameEventQueue *queue, unsigned long long tick) {
+    GameEvent event;
+    while (PollGameEvent(queue, &event)) {
+        stats->counts[event.type]++;
+        if (tick > event.tick && tick - event.tick > stats->maxTickDelay) stats->maxTickDelay = tick - event.tick;
+    }
+}
+
+void LogEventStats(const EventStats *stats, const Simulation *sim) {
+    TraceLog(LOG_INFO, "EVENTS: %u wall bounces, %u paddle hits, %u goals, %u scene changes, consumed up to %llu ticks late",
+             stats->counts[EVENT_WALL_BOUNCE], stats->counts[EVENT_PADDLE_HIT], stats->counts[EVENT_GOAL],
+             stats->counts[EVENT_SCENE_CHANGE], stats->maxTickDelay);
+    TraceLog(LOG_INFO, "EVENTS: dropped %u for audio, %u for effects, %u for stats",
+             atomic_load(&sim->events.queues[EVENT_CONSUMER_AUDIO].dropped),
+             atomic_load(&sim->events.queues[EVENT_CONSUMER_EFFECTS].dropped),
+             atomic_load(&sim->events.queues[EVENT_CONSUMER_STATS].dropped));
+}
+
+void InterpolateSnapshot(const GameSnapshot *prev, const GameSnapshot *next, double time, GameSnapshot *out) {
+    *out = *next;
+
+    double span = next->time - prev->time;
+    if (span <= 0.0) return;
+    float t = Clamp((float)((time - prev->time) / span), 0.0f, 1.0f);
+    out->time = prev->time + t * span; // The moment the view shows
+
+    out->leftPaddle.rect.y = Lerp(prev->leftPaddle.rect.y, next->leftPaddle.rect.y, t);
+    out->rightPaddle.rect.y = Lerp(prev->rightPaddle.rect.y, next->rightPaddle.rect.y, t);
+
+    // A reset teleports the ball to the center, blending across it would smear it over the field
+    if (prev->ball.resets == next->ball.resets)
+        out->ball.position = Vector2Lerp(prev->ball.position, next->ball.position, t);
+}
+
+void InitSimulation(Simulation *sim, const Config *config) {
+    *sim = (Simulation){ 0 };
+
+    GameState state = {
+        .leftScore = 0,
+        .rightScore = 0,
+        .isPaused = false,
+        .currentScene = MAIN_MENU,
+        .prevScene = 0,
+        .aiPlayer = true,
+    };
+
+#ifdef DEV_MODE
+    state.currentScene = PREGAME;
+#endif
+    if (config->latencyTest) state.currentScene = LATENCY_TEST;
+    if (config->stallTest > 0) state.currentScene = PREGAME; // Ticks without input, unlike the menu
+    if (config->benchmark > 0) state.currentScene = GAME;
+
+    Paddle leftPaddle = {{50, (int)((playfieldHeight / 2)) - (PADDLE_HEIGHT / 2), PADDLE_WIDTH, PADDLE_HEIGHT}, 500.0f};
+    Paddle rightPaddle = {{playfieldWidth - 50 - PADDLE_WIDTH, (int)((playfieldHeight / 2)) - (PADDLE_HEIGHT / 2), PADDLE_WIDTH, PADDLE_HEIGHT}, 500.0f};
+    Ball ball = {(Vector2){(int)(playfieldWidth / 2),(int)( playfieldHeight / 2)}, (Vector2){1.0f, 1.0f}, BALL_SPEED, 0}; // Direction normalized
+
+    ResetBall(&ball); // Initial reset
+
+    sim->world = (GameSnapshot){ .leftPaddle = leftPaddle, .rightPaddle = rightPaddle, .ball = ball, .state = state };
+    sim->benchmark = (config->benchmark > 0);
+
+    // Slot 0 is the renderer's, slot 1 the shared one and slot 2 the simulation's
+    sim->snapshots.front = 0;
+    sim->snapshots.back = 2;
+    atomic_init(&sim->snapshots.middle, 1);
+    PublishSnapshot(&sim->snapshots, &sim->world);
+
+    pthread_mutex_init(&sim->wakeLock, NULL);
+    pthread_cond_init(&sim->wake, NULL);
+}
+
+static bool IsInputQueueEmpty(InputQueue *queue) {
+    return atomic_load(&queue->head) == atomic_load(&queue->tail);
+}
+
+void PushInput(Simulation *sim, unsigned int button, bool down, double time) {
+    InputQueue *queue = &sim->input;
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (head - atomic_load(&queue->tail) == INPUT_QUEUE_SIZE) {
+        atomic_fetch_add(&sim->droppedInputs, 1); // Never block the sampler
+        return;
+    }
+
+    queue->events[head & (INPUT_QUEUE_SIZE - 1)] = (InputEvent){ time, button, down };
+    atomic_store(&queue->head, head + 1);
+
+    // The simulation sleeps on static scenes until something happens
+    pthread_mutex_lock(&sim->wakeLock);
+    pthread_cond_signal(&sim->wake);
+    pthread_mutex_unlock(&sim->wakeLock);
+}
+
+void PulseInput(Simulation *sim, unsigned int button) {
+    double now = GetTime();
+    PushInput(sim, button, true, now);
+    PushInput(sim, button, false, now);
+}
+
+// Keyboard keys and gamepad buttons sampled on behalf of the simulation
+static const struct { int key; InputButton button; } inputKeys[] = {
+    { KEY_W, INPUT_W }, { KEY_S, INPUT_S }, { KEY_UP, INPUT_UP }, { KEY_DOWN, INPUT_DOWN },
+    { KEY_ENTER, INPUT_ENTER }, { KEY_SPACE, INPUT_SPACE }, { KEY_P, INPUT_P }, { KEY_R, INPUT_R },
+    { KEY_M, INPUT_M }, { KEY_Y, INPUT_Y }, { KEY_N, INPUT_N }, { KEY_ESCAPE, INPUT_EXIT },
+};
+
+// First gamepad plays the right paddle and drives the menus, the second one the left paddle
+static const struct { int gamepad; int button; InputButton input; } inputButtons[] = {
+    { 0, GAMEPAD_BUTTON_LEFT_FACE_UP, INPUT_UP }, { 0, GAMEPAD_BUTTON_LEFT_FACE_DOWN, INPUT_DOWN },
+    { 0, GAMEPAD_BUTTON_RIGHT_FACE_DOWN, INPUT_ENTER }, { 0, GAMEPAD_BUTTON_MIDDLE_RIGHT, INPUT_P },
+    { 1, GAMEPAD_BUTTON_LEFT_FACE_UP, INPUT_W }, { 1, GAMEPAD_BUTTON_LEFT_FACE_DOWN, INPUT_S },
+};
+
+// The terminal backend's keys, arrows come as escape sequences or, on Windows, after a prefix byte
+static const struct { int key; InputButton button; } terminalKeys[] = {
+    { 'w', INPUT_W }, { 's', INPUT_S }, { '\r', INPUT_ENTER }, { '\n', INPUT_ENTER }, { ' ', INPUT_SPACE },
+    { 'p', INPUT_P }, { 'r', INPUT_R }, { 'm', INPUT_M }, { 'y', INPUT_Y }, { 'n', INPUT_N },
+};
+
+static unsigned int ReadTerminalKeys(InputSampler *sampler, Simulation *sim, double now) {
+    for (int key = ReadTerminalByte(); key >= 0; key = ReadTerminalByte()) {
+        unsigned int button = 0;
+        if (key == 0x1b) {
+            // A lone escape is the key itself, ESC [ A and ESC O A are the arrows
+            int next = ReadTerminalByte();
+            if (next < 0) {
+                PulseInput(sim, INPUT_EXIT);
+                sampler->events++;
+                continue;
+            }
+            int arrow = (next == '[' || next == 'O') ? ReadTerminalByte() : -1;
+            button = (arrow == 'A') ? INPUT_UP : (arrow == 'B') ? INPUT_DOWN : 0;
+        } else if (key == 0 || key == 0xe0) {
+            int arrow = ReadTerminalByte();
+            button = (arrow == 'H') ? INPUT_UP : (arrow == 'P') ? INPUT_DOWN : 0;
+        } else {
+            for (int i = 0; i < (int)(sizeof(terminalKeys) / sizeof(terminalKeys[0])); i++) {
+                if (tolower(key) == terminalKeys[i].key) button = terminalKeys[i].button;
+            }
+        }
+
+        for (int bit = 0; bit < 16; bit++) {
+            if (button & (1u << bit)) sampler->terminalHeldUntil[bit] = now + TERMINAL_KEY_HOLD;
+        }
+    }
+
+    unsigned int down = 0;
+    for (int bit = 0; bit < 16; bit++) {
+        if (sampler->terminalHeldUntil[bit] > now) down |= 1u << bit;
+    }
+    return down;
+}
+
+// Main thread only: raylib input state is refreshed by PollInputEvents()
+void SampleInput(InputSampler *sampler, Simulation *sim) {
+    double now = GetTime();
+
+    // Synthetic presses go through the same path as real ones, at any point of the frame
+    if (sampler->synthetic && now >= sampler->syntheticAt) {
+        if (sampler->syntheticHeld) {
+            sampler->syntheticHeld = 0;
+            sampler->syntheticAt = now + LATENCY_SYNTHETIC_PERIOD + GetRandomValue(0, 50) / 1000.0;
+        } else {
+            sampler->syntheticHeld = (sampler->syntheticNext == INPUT_UP) ? INPUT_UP : INPUT_DOWN;
+            sampler->syntheticNext = (sampler->syntheticHeld == INPUT_UP) ? INPUT_DOWN : INPUT_UP;
+            sampler->syntheticAt = now + LATENCY_SYNTHETIC_HOLD;
+        }
+    }
+
+    unsigned int down = sampler->syntheticHeld;
+    if (sampler->terminal) down |= ReadTerminalKeys(sampler, sim, now);
+    for (int i = 0; i < (int)(sizeof(inputKeys) / sizeof(inputKeys[0])); i++) {
+        if (IsKeyDown(inputKeys[i].key)) down |= inputKeys[i].button;
+    }
+    for (int i = 0; i < (int)(sizeof(inputButtons) / sizeof(inputButtons[0])); i++) {
+        if (IsGamepadAvailable(inputButtons[i].gamepad) && IsGamepadButtonDown(inputButtons[i].gamepad, inputButtons[i].button))
+            down |= inputButtons[i].input;
+    }
+
+    unsigned int changed = down ^ sampler->down;
+    for (unsigned int button = 1; changed != 0; button <<= 1) {
+        if (!(changed & button)) continue;
+        changed &= ~button;
+        PushInput(sim, button, (down & button) != 0, now);
+        sampler->events++;
+    }
+    sampler->down = down;
+
+    // The close flag stays raised, only its first frame counts as a press
+    bool closeRequested = WindowShouldClose();
+    if (closeRequested && !sampler->closeRequested) {
+        PulseInput(sim, INPUT_EXIT);
+        sampler->events++;
+    }
+    sampler->closeRequested = closeRequested;
+}
+
+double GetInputLatencyAverage(Simulation *sim) {
+    unsigned int presses = atomic_load(&sim->inputPresses);
+    return (presses > 0) ? atomic_load(&sim->inputLatencyTotal) / presses : 0.0;
+}
+
+// Whether the tick timing stayed within bounds through the render stalls of --stall-test
+bool CheckStallTest(Simulation *sim, unsigned long long ticks) {
+    unsigned int late = atomic_load(&sim->lateTicks);
+    double maxLag = atomic_load(&sim->maxTickLag);
+    bool passed = (maxLag <= STALL_TEST_MAX_LAG && late <= ticks * STALL_TEST_MAX_LATE_RATIO);
+
+    TraceLog(passed ? LOG_INFO : LOG_WARNING, "STALL TEST: %s, %llu ticks, %u late (%.0f allowed), max lag %.2f ms (%.2f ms allowed)",
+             passed ? "passed" : "FAILED", ticks, late, ticks * STALL_TEST_MAX_LATE_RATIO, maxLag * 1000.0, STALL_TEST_MAX_LAG * 1000.0);
+    return passed;
+}
+
+static bool WaitForInput(Simulation *sim) {
+    pthread_mutex_lock(&sim->wakeLock);
+    while (atomic_load(&sim->running) && IsInputQueueEmpty(&sim->input))
+        pthread_cond_wait(&sim->wake, &sim->wakeLock);
+    pthread_mutex_unlock(&sim->wakeLock);
+    return atomic_load(&sim->running);
+}
+
+// Applies the queued events sampled up to the tick time, later ones wait for their own tick
+static SimInput ConsumeInput(Simulation *sim, double tickTime) {
+    InputQueue *queue = &sim->input;
+    SimInput input = { .down = sim->inputDown, .pressed = 0 };
+
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    while (tail != atomic_load(&queue->head)) {
+        InputEvent event = queue->events[tail & (INPUT_QUEUE_SIZE - 1)];
+        if (event.time > tickTime) break;
+
+        if (event.down) {
+            input.down |= event.button;
+            input.pressed |= event.button;
+        }
+        else input.down &= ~event.button;
+
+        if (event.down && (event.button & INPUT_PADDLE_BUTTONS)) {
+            sim->world.presses++;
+            sim->world.lastPressTime = event.time;
+
+            double latency = GetTime() - event.time;
+            atomic_fetch_add(&sim->inputPresses, 1);
+            atomic_store(&sim->inputLatencyTotal, atomic_load(&sim->inputLatencyTotal) + latency);
+            if (latency > atomic_load(&sim->inputLatencyMax)) atomic_store(&sim->inputLatencyMax, latency);
+        }
+
+        atomic_store(&queue->tail, ++tail);
+    }
+
+    sim->inputDown = input.down;
+    return input;
+}
+
+static void *SimulationThread(void *arg) {
+    Simulation *sim = arg;
+    double nextTick = GetTime();
+
+    while (atomic_load(&sim->running)) {
+        double now = GetTime();
+        if (now < nextTick) {
+            WaitTime(nextTick - now);
+            continue;
+        }
+
+        double lag = now - nextTick;
+        if (lag > SIM_DT) atomic_fetch_add(&sim->lateTicks, 1);
+        if (lag > atomic_load(&sim->maxTickLag)) atomic_store(&sim->maxTickLag, lag);
+        if (lag > SIM_MAX_CATCHUP_TICKS * SIM_DT) nextTick = now;
+
+        SimInput input = ConsumeInput(sim, nextTick);
+        if (sim->benchmark) {
+            // The match plays itself and starts over, so it never turns into a static scene
+            input.down |= GetDemoInput(&sim->world.rightPaddle, &sim->world.ball);
+            if (sim->world.state.currentScene == GAME_OVER) input.pressed |= INPUT_R;
+        }
+        sim->events.tick = sim->world.tick + 1;
+        sim->events.time = now;
+        UpdateScene(&sim->world, &input, &sim->events);
+        sim->world.tick++;
+        sim->world.time = nextTick;
+        PublishSnapshot(&sim->snapshots, &sim->world);
+        nextTick += SIM_DT;
+
+        // Nothing moves on a static scene, so sleep until the player presses something
+        if (IsStaticScene(&sim->world.state) && !sim->world.state.exitRequested && !sim->benchmark) {
+            if (!WaitForInput(sim)) break;
+            nextTick = GetTime();
+        }
+    }
+
+    return NULL;
+}
+
+void StartSimulation(Simulation *sim) {
+    atomic_store(&sim->running, true);
+    pthread_create(&sim->thread, NULL, SimulationThread, sim);
+}
+
+void StopSimulation(Simulation *sim) {
+    pthread_mutex_lock(&sim->wakeLock);
+    atomic_store(&sim->running, false);
+    pthread_cond_signal(&sim->wake);
+    pthread_mutex_unlock(&sim->wakeLock);
+
+    pthread_join(sim->thread, NULL);
+    pthread_cond_destroy(&sim->wake);
+    pthread_mutex_destroy(&sim->wakeLock);
+}
+
+void UpdateScene(GameSnapshot *world, const SimInput *input, GameEvents *events) {
+    GameState *state = &world->state;
+    Scene scene = state->currentScene;
+
+    if (input->pressed & INPUT_EXIT) {
+        state->prevScene = state->currentScene;
+        state->currentScene = EXIT_WINDOW;
+    }
+
+    if (state->currentScene == EXIT_WINDOW) {
+        if (input->pressed & INPUT_Y) state->exitRequested = true;
+        else if (input->pressed & INPUT_N) state->currentScene = state->prevScene;
+    }
+
+    switch (state->currentScene) {
+        case MAIN_MENU:
+            if (input->pressed & INPUT_ENTER) {
+                state->currentScene = PREGAME;
+
+                state->aiPlayer = true;
+            }
+            else if (input->pressed & INPUT_SPACE) {
+                state->currentScene = GAME;
+                state->aiPlayer = false;
+            }
+            break;
+        case PREGAME:
+            if (input->pressed & (INPUT_SPACE | INPUT_ENTER | INPUT_W | INPUT_UP | INPUT_S | INPUT_DOWN))
+                state->currentScene = GAME;
+            break;
+        case GAME:
+            if (!state->isPaused)
+                GameLogic(&world->leftPaddle, &world->rightPaddle, &world->ball, state, input, SIM_DT, events);
+            if (input->pressed & INPUT_P) {
+                state->isPaused = !state->isPaused;
+            }
+            if (input->pressed & INPUT_SUSPEND) {
+                state->isPaused = true; // Nobody is playing a match that is out of focus
+            }
+            break;
+        case GAME_OVER:
+            world->ball.speed = 0.0f;
+            if (input->pressed & INPUT_R) {
+                state->leftScore = 0;
+                state->rightScore = 0;
+                ResetBall(&world->ball);
+                state->currentScene = GAME;
+            }
+            else if (input->pressed & INPUT_M) {
+                state->currentScene = MAIN_MENU;
+            }
+            break;
+        case LATENCY_TEST:
+            // No ball and no AI: every movement of the paddle comes from a press being measured
+            if ((input->down & INPUT_UP) && world->rightPaddle.rect.y > 0) {
+                world->rightPaddle.rect.y -= world->rightPaddle.speed * SIM_DT;
+            }
+            if ((input->down & INPUT_DOWN) && world->rightPaddle.rect.y < playfieldHeight - PADDLE_HEIGHT) {
+                world->rightPaddle.rect.y += world->rightPaddle.speed * SIM_DT;
+            }
+            break;
+        default: break;
+    }
+
+    if (state->currentScene != scene)
+        PushGameEvent(events, (GameEvent){ .type = EVENT_SCENE_CHANGE, .scene = state->currentScene, .position = world->ball.position });
+}
+
+// Stands in for the right-hand player: chases the ball with a dead zone, so it still
+// misses once the ball speeds up
+unsigned int GetDemoInput(const Paddle *paddle, const Ball *ball) {
+    float offset = ball->position.y - (paddle->rect.y + PADDLE_HEIGHT / 2);
+    if (ball->direction.x > 0 && offset < -PADDLE_HEIGHT / 4) return INPUT_UP;
+    if (ball->direction.x > 0 && offset > PADDLE_HEIGHT / 4) return INPUT_DOWN;
+    return 0;
+}
+
+void GameLogic(Paddle *leftPaddle, Paddle *rightPaddle, Ball *ball, GameState *state, const SimInput *input, float dt, GameEvents *events) {
+    if (state->aiPlayer) {
+        if(ball->direction.x > 0) {
+        // If the ball is moving away from the left paddle
+        // Move the paddle slowly towards the center of the screen
+        float centerY = (playfieldHeight - leftPaddle->rect.height) / 2;
+        float distanceToCenter = centerY - (leftPaddle->rect.y + leftPaddle->rect.height / 2);
+
+        if (fabs(distanceToCenter) > 10.0f) { // Only move if the distance is significant
+            if (distanceToCenter > 0) {
+                leftPaddle->rect.y += (leftPaddle->speed) * dt; // Move down slowly
+            } else {
+                leftPaddle->rect.y -= (leftPaddle->speed) * dt; // Move up slowly
+            }
+        }
+        else {
+            leftPaddle = leftPaddle;
+        }
+        } else {
+
+            // Calculate the target position based on the ball's position
+            float targetY = ball->position.y;
+
+            // Calculate the distance to the target position
+            float distance = targetY - (leftPaddle->rect.y + leftPaddle->rect.height / 2);
+
+            // Move the paddle towards the ball's position
+            if (fabs(distance) > 1.0f) { // Only move if the distance is significant
+                if (distance > 0) {
+                    leftPaddle->rect.y += leftPaddle->speed * dt; // Move down
+                } else {
+                    leftPaddle->rect.y -= leftPaddle->speed * dt; // Move up
+                }
+            }
+
+            // Clamp the paddle's position to stay within the game boundaries
+            if (leftPaddle->rect.y < 0) {
+                leftPaddle->rect.y = 0;
+            } else if (leftPaddle->rect.y > playfieldWidth - leftPaddle->rect.height) {
+                leftPaddle->rect.y = playfieldHeight - leftPaddle->rect.height;
+            }
+        }
+
+        // Extended Player Input
+        if ((input->down & (INPUT_W | INPUT_UP)) && rightPaddle->rect.y > 0) {
+            rightPaddle->rect.y -= rightPaddle->speed * dt;
+        }
+        if ((input->down & (INPUT_S | INPUT_DOWN)) && rightPaddle->rect.y < playfieldHeight - PADDLE_HEIGHT) {
+            rightPaddle->rect.y += rightPaddle->speed * dt;
+        }
+    } else {
+        // Two PlayerInput
+        if ((input->down & INPUT_W) && leftPaddle->rect.y > 0) {
+            leftPaddle->rect.y -= leftPaddle->speed * dt;
+        }
+        if ((input->down & INPUT_S) && leftPaddle->rect.y < playfieldHeight - PADDLE_HEIGHT) {
+            leftPaddle->rect.y += leftPaddle->speed * dt;
+        }
+        if ((input->down & INPUT_UP) && rightPaddle->rect.y > 0) {
+            rightPaddle->rect.y -= rightPaddle->speed * dt;
+        }
+        if ((input->down & INPUT_DOWN) && rightPaddle->rect.y < playfieldHeight - PADDLE_HEIGHT) {
+            rightPaddle->rect.y += rightPaddle->speed * dt;
+        }
+    }
+
+    // Update ball position
+    ball->position.x += ball->direction.x * ball->speed * dt;
+    ball->position.y += ball->direction.y * ball->speed * dt;
+
+    // Ball collision with top and bottom
+    if (ball->position.y <= 0 || ball->position.y >= playfieldHeight - BALL_SIZE) {
+        ball->direction.y *= -1; // Reverse Y direction
+        EmitGameEvent(events, EVENT_WALL_BOUNCE, ball->position);
+    }
+
+    // Ball collision with paddles
+    if (CheckCollisionCircleRec(ball->position, BALL_SIZE / 2, leftPaddle->rect) || 
+        CheckCollisionCircleRec(ball->position, BALL_SIZE / 2, rightPaddle->rect)) {
+        ball->direction.x *= -1; // Reverse X direction
+        ball->speed += BALL_SPEED / 10.0;
+        EmitGameEvent(events, EVENT_PADDLE_HIT, ball->position);
+    }
+
+    // Scoring
+    if (ball->position.x < 0) {
+        EmitGameEvent(events, EVENT_GOAL, (Vector2){ 0, ball->position.y });
+        state->rightScore++; // Right player scores
+        ResetBall(ball);
+    }
+    if (ball->position.x > playfieldWidth) {
+        EmitGameEvent(events, EVENT_GOAL, (Vector2){ playfieldWidth, ball->position.y });
+        state->leftScore++;  // Left player scores
+        ResetBall(ball);
+    }
+
+    if (state->leftScore == WIN_SCORE or state->rightScore == WIN_SCORE)
+        state->currentScene = GAME_OVER;
+
+    // TraceLog(LOG_DEBUG, "After Update: x: %f, y: %f", ball->direction.x, ball->direction.y);
+}
+
+void ResetBall(Ball *ball) {
+    ball->position = (Vector2){(int)(playfieldWidth / 2),(int)( playfieldHeight / 2)};
+    ball->direction.x = (GetRandomValue(0, 1) == 0) ? 1.0f : -1.0f; // Randomize initial direction
+    ball->direction.y = (GetRandomValue(-1, 1) < 0) ? 1.0f : -1.0f; // Randomize initial vertical direction
+    ball->speed = BALL_SPEED;
+    ball->resets++;
+}
@@ -0,0 +1,204 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "game.h"
+
+#define SIM_TICK_RATE 120
+#define SIM_DT (1.0 / SIM_TICK_RATE)
+#define SIM_MAX_CATCHUP_TICKS 8     // Beyond this the simulation drops time instead of fast-forwarding
+#define STALL_TEST_DURATION 0.25    // Render stall injected by --stall-test, 30 ticks long
+#define STALL_TEST_PERIOD 0.5       // Normal frames between two stalls, and after the last one
+#define STALL_TEST_MAX_LAG (4 * SIM_DT)     // A stall leaking into the tick shows up as a lag near its duration
+#define STALL_TEST_MAX_LATE_RATIO 0.01      // Share of ticks that may start late, for scheduler noise
+
+#define TRIPLE_BUFFER_FRESH 0x4u    // Set on the shared slot index when it holds an unread snapshot
+
+#define INPUT_QUEUE_SIZE 256        // Power of two
+#define INPUT_SAMPLE_PERIOD 0.001   // Input is sampled at 1 kHz while the main thread waits for the next frame
+#define TERMINAL_KEY_HOLD 0.12      // A key read from the terminal counts as held this long, auto-repeat extends it
+
+#define GAME_EVENT_QUEUE_SIZE 256   // Power of two, per consumer
+
+// Buttons the simulation reacts to. Raylib input can only be polled on the main
+// thread, so it samples the keyboard and hands these bits to the simulation.
+typedef enum {
+    INPUT_W = 1 << 0,
+    INPUT_S = 1 << 1,
+    INPUT_UP = 1 << 2,
+    INPUT_DOWN = 1 << 3,
+    INPUT_ENTER = 1 << 4,
+    INPUT_SPACE = 1 << 5,
+    INPUT_P = 1 << 6,
+    INPUT_R = 1 << 7,
+    INPUT_M = 1 << 8,
+    INPUT_Y = 1 << 9,
+    INPUT_N = 1 << 10,
+    INPUT_EXIT = 1 << 11,       // Escape or window close button
+    INPUT_SUSPEND = 1 << 12     // Window went to the background
+} InputButton;
+
+// Buttons that move a paddle. Only their presses are counted and timed: menu keys
+// and the synthetic exit and suspend pulses never move anything on screen.
+#define INPUT_PADDLE_BUTTONS (INPUT_W | INPUT_S | INPUT_UP | INPUT_DOWN)
+
+typedef struct {
+    unsigned int down;          // Buttons held
+    unsigned int pressed;       // Buttons pressed since the previous tick
+} SimInput;
+
+typedef struct {
+    double time;                // GetTime() when the change was sampled
+    unsigned int button;
+    bool down;
+} InputEvent;
+
+// Lock-free single producer/single consumer queue of timestamped input changes
+typedef struct {
+    InputEvent events[INPUT_QUEUE_SIZE];
+    atomic_uint head;           // Next slot to write, advanced by the main thread
+    atomic_uint tail;           // Next slot to read, advanced by the simulation thread
+} InputQueue;
+
+// Main thread side of the input path: turns keyboard/gamepad state into events
+typedef struct {
+    unsigned int down;          // Buttons held at the last sample
+    bool closeRequested;
+    int events;                 // Events pushed since the counter was last cleared
+
+    // Synthetic presses for the latency test, alternating up and down
+    bool synthetic;
+    unsigned int syntheticHeld;
+    unsigned int syntheticNext;
+    double syntheticAt;         // Time of the next synthetic press or release
+
+    // Keys read from stdin for the terminal backend. A terminal reports presses but
+    // no releases, so each key is held until its time here runs out.
+    bool terminal;
+    double terminalHeldUntil[16];   // Per button bit
+} InputSampler;
+
+// What happened during a tick, for everything that reacts to the game without
+// being part of it: sounds, effects, statistics
+typedef enum {
+    EVENT_WALL_BOUNCE,          // Ball off the top or bottom wall
+    EVENT_PADDLE_HIT,
+    EVENT_GOAL,
+    EVENT_SCENE_CHANGE,
+    EVENT_TYPE_COUNT
+} GameEventType;
+
+typedef struct {
+    unsigned char type;         // GameEventType
+    unsigned char scene;        // Scene entered, for EVENT_SCENE_CHANGE
+    Vector2 position;           // Playfield position it happened at
+    unsigned long long tick;
+    double time;                // GetTime() when the tick started
+} GameEvent;
+
+// Each consumer reads its own copy of the events at its own pace
+typedef enum {
+    EVENT_CONSUMER_AUDIO,       // Synth callback, or the main thread for sampled sounds
+    EVENT_CONSUMER_EFFECTS,     // Particles, main thread
+    EVENT_CONSUMER_STATS,       // Main thread
+    EVENT_CONSUMER_COUNT
+} EventConsumer;
+
+// Lock-free single producer/single consumer queue of game events
+typedef struct {
+    GameEvent events[GAME_EVENT_QUEUE_SIZE];
+    atomic_uint head;           // Next slot to write, advanced by the simulation thread
+    atomic_uint tail;           // Next slot to read, advanced by the consumer
+    atomic_uint dropped;        // Events this consumer lost to a full queue
+} GameEventQueue;
+
+// The simulation fans every event out to one queue per consumer. It never waits:
+// a consumer that falls behind loses events rather than stalling the tick.
+typedef struct {
+    GameEventQueue queues[EVENT_CONSUMER_COUNT];
+    unsigned long long tick;    // Stamped on the events, owned by the simulation thread
+    double time;
+} GameEvents;
+
+// Event counts, kept by the stats consumer
+typedef struct {
+    unsigned int counts[EVENT_TYPE_COUNT];
+    unsigned long long maxTickDelay;    // Most ticks between an event and its consumption
+} EventStats;
+
+// Everything the renderer needs from one simulation tick. Immutable once published.
+typedef struct {
+    Paddle leftPaddle;
+    Paddle rightPaddle;
+    Ball ball;
+    GameState state;
+    unsigned int presses;       // Presses applied so far
+    double lastPressTime;       // Sample time of the latest of them
+    unsigned long long tick;
+    double time;                // GetTime() at the tick
+} GameSnapshot;
+
+// Lock-free single producer/single consumer triple buffer: the simulation always
+// has a slot to write, the renderer always has a complete snapshot to read, and
+// neither ever waits for the other.
+typedef struct {
+    GameSnapshot slots[3];
+    atomic_uint middle;         // Slot index handed over between the threads, | TRIPLE_BUFFER_FRESH
+    unsigned int back;          // Owned by the simulation thread
+    unsigned int front;         // Owned by the render thread
+} TripleBuffer;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t wakeLock;
+    pthread_cond_t wake;
+    atomic_bool running;
+
+    InputQueue input;
+    TripleBuffer snapshots;
+    GameEvents events;
+    Sounds sounds;              // Owned by the main thread, played from the audio event queue
+
+    GameSnapshot world;         // Owned by the simulation thread
+    bool benchmark;             // Plays the right paddle too, for --benchmark
+    unsigned int inputDown;     // Owned by the simulation thread
+
+    // Sample-to-tick input latency of presses, written by the simulation thread
+    atomic_uint inputPresses;
+    atomic_uint droppedInputs;  // Events lost to a full queue
+    _Atomic double inputLatencyTotal;
+    _Atomic double inputLatencyMax;
+
+    // Tick timing, written by the simulation thread, read for diagnostics
+    atomic_uint lateTicks;      // Ticks started more than one tick period late
+    _Atomic double maxTickLag;
+} Simulation;
+
+void InitSimulation(Simulation *sim, const Config *config);
+void StartSimulation(Simulation *sim);
+void StopSimulation(Simulation *sim);
+void PushInput(Simulation *sim, unsigned int button, bool down, double time);
+void PulseInput(Simulation *sim, unsigned int button);
+void SampleInput(InputSampler *sampler, Simulation *sim);
+double GetInputLatencyAverage(Simulation *sim);
+bool CheckStallTest(Simulation *sim, unsigned long long ticks);
+bool ReadSnapshot(Simulation *sim, GameSnapshot *snapshot);
+bool IsSnapshotChanged(const GameSnapshot *prev, const GameSnapshot *next);
+void InterpolateSnapshot(const GameSnapshot *prev, const GameSnapshot *next, double time, GameSnapshot *out);
+
+void EmitGameEvent(GameEvents *events, GameEventType type, Vector2 position);
+bool PollGameEvent(GameEventQueue *queue, GameEvent *event);
+void UpdateEventStats(EventStats *stats, GameEventQueue *queue, unsigned long long tick);
+void LogEventStats(const EventStats *stats, const Simulation *sim);
+
+void UpdateScene(GameSnapshot *world, const SimInput *input, GameEvents *events);
+unsigned int GetDemoInput(const Paddle *paddle, const Ball *ball);
+void GameLogic(Paddle *leftPaddle, Paddle *rightPaddle, Ball *ball, GameState *state, const SimInput *input, float dt, GameEvents *events);
+void ResetBall(Ball *ball);
+
+// Main loop pacing lives in game.c but drives the input sampler
+void WaitForNextFrame(const FramePacer *pacer, const FrameScheduler *scheduler, InputSampler *sampler, Simulation *sim);
+
+#endif // SIM_H
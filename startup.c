@@ -0,0 +1,73 @@
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#endif
+
+#include <stdio.h>
+
+#include "startup.h"
+
+// Phases begin on the main thread and the loader thread at once, each takes its slot atomically
+static StartupProfile profile;
+
+double GetStartupClock(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+#endif
+}
+
+void StartStartupProfile(void) {
+    profile.origin = GetStartupClock();
+    atomic_store(&profile.count, 0);
+}
+
+int BeginStartupPhase(const char *name, const char *detail, const char *thread) {
+    int phase = atomic_fetch_add(&profile.count, 1);
+    if (phase >= STARTUP_MAX_PHASES) return -1;
+
+    profile.phases[phase] = (StartupPhase){ .name = name, .detail = detail, .thread = thread, .start = GetStartupClock() - profile.origin };
+    return phase;
+}
+
+void EndStartupPhase(int phase) {
+    if (phase < 0) return;
+    profile.phases[phase].end = GetStartupClock() - profile.origin;
+}
+
+void MarkStartupPhase(const char *name, const char *thread) {
+    // A milestone, measured from the very start
+    int phase = BeginStartupPhase(name, NULL, thread);
+    if (phase < 0) return;
+    profile.phases[phase].start = 0.0;
+    EndStartupPhase(phase);
+}
+
+void WriteStartupReport(const char *fileName) {
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL) return;
+
+    // Called after every thread that records phases has been joined
+    int count = atomic_load(&profile.count);
+    if (count > STARTUP_MAX_PHASES) count = STARTUP_MAX_PHASES;
+
+    fprintf(file, "# Startup phases in ms since main() started; phases on different threads overlap\n");
+    fprintf(file, "# phase start duration thread\n");
+    for (int i = 0; i < count; i++) {
+        const StartupPhase *phase = &profile.phases[i];
+        char name[128];
+        if (phase->detail != NULL) snprintf(name, sizeof(name), "%s:%s", phase->name, phase->detail);
+        else snprintf(name, sizeof(name), "%s", phase->name);
+        fprintf(file, "%-48s %9.3f %9.3f %s\n", name, phase->start * 1000.0, (phase->end - phase->start) * 1000.0, phase->thread);
+    }
+    fclose(file);
+}
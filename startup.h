@@ -0,0 +1,33 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdatomic.h>
+
+#define STARTUP_MAX_PHASES 32
+#define STARTUP_REPORT_FILE "startup_report.txt"
+
+typedef struct {
+    const char *name;           // No spaces, the benchmark script splits on them
+    const char *detail;         // Asset name and the like, or NULL
+    const char *thread;
+    double start;               // Seconds since StartStartupProfile()
+    double end;
+} StartupPhase;
+
+// Timeline of everything main() and the loader thread do before the game is
+// interactive. Times come from the OS monotonic clock, since raylib's GetTime()
+// only starts with InitWindow().
+typedef struct {
+    double origin;
+    StartupPhase phases[STARTUP_MAX_PHASES];
+    atomic_int count;
+} StartupProfile;
+
+double GetStartupClock(void);
+void StartStartupProfile(void);
+int BeginStartupPhase(const char *name, const char *detail, const char *thread);
+void EndStartupPhase(int phase);
+void MarkStartupPhase(const char *name, const char *thread);
+void WriteStartupReport(const char *fileName);
+
+#endif // STARTUP_H
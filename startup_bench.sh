@@ -0,0 +1,67 @@
+#!/bin/sh
+# Cold and warm start benchmark under a virtual framebuffer.
+#   ./startup_bench.sh [N] [game options...]
+# Runs the game N times cold and N times warm with --exit-after-first-frame and
+# prints percentiles of the wall time to exit and of every phase in the
+# startup_report.txt each run leaves next to the executable.
+#
+# Cold runs drop the page cache first, which needs root; without it they are
+# reported as warm-ish and a warning is printed. Needs Xvfb and GNU date.
+
+set -e
+
+RUNS=${1:-20}
+[ $# -gt 0 ] && shift
+
+cd "$(dirname "$0")"
+GAME=./game
+[ -x "$GAME" ] || GAME=./game.exe
+REPORT=startup_report.txt
+DATA=$(mktemp)
+
+# One server for all runs, so its own startup is not measured
+Xvfb :99 -screen 0 1920x1080x24 -nolisten tcp >/dev/null 2>&1 &
+XVFB=$!
+export DISPLAY=:99
+trap 'rm -f "$DATA"; kill "$XVFB"' EXIT
+sleep 1
+
+if [ "$(id -u)" -ne 0 ]; then
+    echo "warning: not root, cold runs cannot drop the page cache" >&2
+fi
+
+for mode in cold warm; do
+    i=0
+    while [ "$i" -lt "$RUNS" ]; do
+        if [ "$mode" = cold ] && [ "$(id -u)" -eq 0 ]; then
+            sync
+            echo 3 > /proc/sys/vm/drop_caches
+        fi
+
+        rm -f "$REPORT"
+        start=$(date +%s%N)
+        "$GAME" --exit-after-first-frame "$@" >/dev/null 2>&1
+        end=$(date +%s%N)
+
+        awk -v mode="$mode" -v ns=$((end - start)) 'BEGIN { printf "%s process_wall_time %.3f\n", mode, ns / 1e6 }' >> "$DATA"
+        grep -v '^#' "$REPORT" | awk -v mode="$mode" '{ print mode, $1, $3 }' >> "$DATA"
+        i=$((i + 1))
+    done
+done
+
+# Nearest-rank percentiles per mode and phase, in ms
+printf "%-5s %-48s %5s %9s %9s %9s %9s\n" mode phase runs p50 p90 p99 max
+sort -k1,1 -k2,2 -k3,3n "$DATA" | awk '
+    function rank(p,    r) {
+        r = int(p * n)
+        if (r < p * n) r++
+        return v[(r < 1) ? 1 : r]
+    }
+    function flush() {
+        if (n == 0) return
+        printf "%-5s %-48s %5d %9.3f %9.3f %9.3f %9.3f\n", mode, phase, n, rank(0.50), rank(0.90), rank(0.99), v[n]
+    }
+    $1 != mode || $2 != phase { flush(); mode = $1; phase = $2; n = 0 }
+    { v[++n] = $3 }
+    END { flush() }
+'
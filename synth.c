@@ -0,0 +1,93 @@
+#include "synth.h"
+
+// Raylib's stream callback takes no user pointer, and there is only ever one synth
+static Synth *activeSynth = NULL;
+
+static void StartVoice(Synth *synth, GameEventType type) {
+    // Steal the voice closest to finishing when all are busy
+    SynthVoice *voice = &synth->voices[0];
+    for (int i = 1; i < SYNTH_VOICES && voice->remaining > 0.0f; i++)
+        if (synth->voices[i].remaining < voice->remaining) voice = &synth->voices[i];
+
+    switch (type) {
+        case EVENT_WALL_BOUNCE: *voice = (SynthVoice){ .frequency = 880.0f, .length = 0.06f }; break;                   // beep
+        case EVENT_GOAL: *voice = (SynthVoice){ .frequency = 1320.0f, .length = 0.25f }; break;                         // peep
+        case EVENT_PADDLE_HIT: *voice = (SynthVoice){ .frequency = 440.0f, .sweep = -2400.0f, .length = 0.05f }; break; // plop
+        default: return;
+    }
+    voice->remaining = voice->length;
+}
+
+static void SynthCallback(void *bufferData, unsigned int frames) {
+    Synth *synth = activeSynth;
+    float *samples = bufferData;
+    double now = GetTime();
+
+    GameEvent event;
+    while (PollGameEvent(synth->events, &event)) {
+        if (event.type == EVENT_SCENE_CHANGE) continue;
+        if (event.time - synth->lastStart[event.type] < SOUND_RATE_LIMIT) {
+            atomic_fetch_add(&synth->limited, 1);
+            continue;
+        }
+        synth->lastStart[event.type] = event.time;
+        StartVoice(synth, event.type);
+
+        double latency = now - event.time;
+        atomic_fetch_add(&synth->played, 1);
+        atomic_store(&synth->latencyTotal, atomic_load(&synth->latencyTotal) + latency);
+        if (latency > atomic_load(&synth->latencyMax)) atomic_store(&synth->latencyMax, latency);
+    }
+
+    const float dt = 1.0f / SYNTH_SAMPLE_RATE;
+    for (unsigned int i = 0; i < frames; i++) {
+        float mix = 0.0f;
+        for (int v = 0; v < SYNTH_VOICES; v++) {
+            SynthVoice *voice = &synth->voices[v];
+            if (voice->remaining <= 0.0f) continue;
+
+            mix += ((voice->phase < 0.5f) ? 1.0f : -1.0f) * (voice->remaining / voice->length);
+            voice->phase += voice->frequency * dt;
+            voice->phase -= floorf(voice->phase);
+            voice->frequency = fmaxf(voice->frequency + voice->sweep * dt, 20.0f);
+            voice->remaining -= dt;
+        }
+        samples[i] = Clamp(mix * SYNTH_VOLUME, -1.0f, 1.0f);
+    }
+}
+
+Synth *LoadSynth(GameEventQueue *events) {
+    Synth *synth = calloc(1, sizeof(Synth));
+    synth->events = events;
+    for (int i = 0; i < EVENT_TYPE_COUNT; i++) synth->lastStart[i] = -SOUND_RATE_LIMIT;
+    activeSynth = synth;
+
+    // Small buffers are the point: each one is latency between trigger and speaker
+    SetAudioStreamBufferSizeDefault(SYNTH_BUFFER_FRAMES);
+    synth->stream = LoadAudioStream(SYNTH_SAMPLE_RATE, 32, 1);
+    SetAudioStreamBufferSizeDefault(0);
+    SetAudioStreamCallback(synth->stream, SynthCallback);
+    PlayAudioStream(synth->stream);
+
+    TraceLog(LOG_INFO, "SYNTH: %d Hz, %d frame buffers (%.1f ms)", SYNTH_SAMPLE_RATE, SYNTH_BUFFER_FRAMES,
+             SYNTH_BUFFER_FRAMES * 1000.0 / SYNTH_SAMPLE_RATE);
+    return synth;
+}
+
+void UnloadSynth(Synth *synth) {
+    if (synth == NULL) return;
+
+    // The stream buffer the callback fills still has to play out after it is mixed
+    unsigned int played = atomic_load(&synth->played);
+    double buffered = 2.0 * SYNTH_BUFFER_FRAMES / SYNTH_SAMPLE_RATE;
+    if (played > 0) {
+        TraceLog(LOG_INFO, "SYNTH: %u sounds, event to mix avg %.2f ms, max %.2f ms, plus up to %.2f ms of stream buffer, %u rate limited",
+                 played, atomic_load(&synth->latencyTotal) / played * 1000.0, atomic_load(&synth->latencyMax) * 1000.0,
+                 buffered * 1000.0, atomic_load(&synth->limited));
+    }
+
+    StopAudioStream(synth->stream);
+    UnloadAudioStream(synth->stream);
+    activeSynth = NULL;
+    free(synth);
+}
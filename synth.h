@@ -0,0 +1,44 @@
+#ifndef SYNTH_H
+#define SYNTH_H
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "sim.h"
+
+#define SYNTH_SAMPLE_RATE 48000
+#define SYNTH_BUFFER_FRAMES 256         // Per stream sub-buffer, ~5.3 ms at 48 kHz
+#define SYNTH_VOICES 8
+#define SYNTH_VOLUME 0.25f
+
+// Square wave with a linear pitch sweep and decay, like the 8-bit samples it replaces
+typedef struct {
+    float phase;
+    float frequency;
+    float sweep;                // Frequency change per second
+    float remaining;            // Seconds left, the voice is free at 0
+    float length;
+} SynthVoice;
+
+// Makes the game sounds procedurally inside the audio stream callback. The audio
+// thread is the consumer of the simulation's audio event queue and drains it at the
+// start of each buffer, so a sound starts at most one small buffer after the event
+// and no sound files are ever loaded.
+struct Synth {
+    AudioStream stream;
+    GameEventQueue *events;
+
+    SynthVoice voices[SYNTH_VOICES];    // Owned by the audio thread
+    double lastStart[EVENT_TYPE_COUNT]; // Owned by the audio thread, for rate limiting
+
+    // Event to first sample mixed, written by the audio thread
+    atomic_uint played;
+    atomic_uint limited;                // Events skipped by the rate limit
+    _Atomic double latencyTotal;
+    _Atomic double latencyMax;
+};
+
+Synth *LoadSynth(GameEventQueue *events);
+void UnloadSynth(Synth *synth);
+
+#endif // SYNTH_H
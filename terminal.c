@@ -0,0 +1,205 @@
+#if defined(_WIN32)
+#include <conio.h>
+#include <io.h>
+#else
+#define _POSIX_C_SOURCE 200809L
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#include <signal.h>
+
+#include "game.h"
+
+// Default colors and a visible cursor, whatever the last frame left behind
+static const char resetSequence[] = "\x1b[0m\x1b[?25h";
+
+static volatile sig_atomic_t started;
+#if !defined(_WIN32)
+static volatile sig_atomic_t raw;
+static struct termios saved;
+#endif
+
+void StopTerminalInput(void) {
+    if (!started) return;
+    started = 0;
+
+    // Only async-signal-safe calls, this also runs from the signal handler
+#if defined(_WIN32)
+    fputs(resetSequence, stdout);
+    fflush(stdout);
+#else
+    if (raw) tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved);
+    raw = 0;
+    if (write(STDOUT_FILENO, resetSequence, sizeof(resetSequence) - 1) < 0) return;
+#endif
+}
+
+// Restore, then die of the signal as if it had never been caught, so the shell sees it
+static void HandleTerminalSignal(int number) {
+    StopTerminalInput();
+    signal(number, SIG_DFL);
+    raise(number);
+}
+
+bool StartTerminalInput(void) {
+    static bool registered = false;
+    if (!registered) atexit(StopTerminalInput);
+    registered = true;
+    signal(SIGINT, HandleTerminalSignal);
+    signal(SIGTERM, HandleTerminalSignal);
+    started = 1;
+
+#if defined(_WIN32)
+    // _getch() already reads unbuffered and without echo
+    return _isatty(_fileno(stdin));
+#else
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved) != 0) return false;
+
+    // Byte by byte without echo, and reads return at once when nothing is pending.
+    // Signals stay on, so Ctrl-C goes through the handler above.
+    struct termios mode = saved;
+    mode.c_lflag &= ~(ICANON | ECHO);
+    mode.c_cc[VMIN] = 0;
+    mode.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &mode) != 0) return false;
+    raw = 1;
+    return true;
+#endif
+}
+
+int ReadTerminalByte(void) {
+#if defined(_WIN32)
+    return _kbhit() ? _getch() : -1;
+#else
+    unsigned char byte;
+    return (raw && read(STDIN_FILENO, &byte, 1) == 1) ? byte : -1;
+#endif
+}
+
+TerminalRenderer *LoadTerminalRenderer(void) {
+    TerminalRenderer *terminal = calloc(1, sizeof(TerminalRenderer));
+    terminal->canvas = GenImageColor(TERMINAL_COLUMNS, 2 * TERMINAL_ROWS, BLANK);
+    terminal->output = malloc(TERMINAL_OUTPUT_SIZE);
+    terminal->row = terminal->column = -1;
+    terminal->fg = terminal->bg = -1;
+    return terminal;
+}
+
+// Nearest xterm 256-color entry: the gray ramp for grays, the 6x6x6 cube otherwise
+static unsigned char GetTerminalColor(Color color) {
+    if (color.r == color.g && color.g == color.b) {
+        if (color.r < 4) return 16;
+        if (color.r > 243) return 231;
+        return 232 + ((color.r > 8) ? (color.r - 3) / 10 : 0); // Ramp levels are 8 + 10 * i
+    }
+    int r = (color.r * 5 + 127) / 255;
+    int g = (color.g * 5 + 127) / 255;
+    int b = (color.b * 5 + 127) / 255;
+    return 16 + 36 * r + 6 * g + b;
+}
+
+static void FlushTerminal(TerminalRenderer *terminal) {
+    fwrite(terminal->output, 1, terminal->length, stdout);
+    terminal->flushed += terminal->length;
+    terminal->length = 0;
+}
+
+// A frame that outgrows the buffer goes out in several writes, never with sequences missing
+static void AppendTerminal(TerminalRenderer *terminal, const char *text) {
+    size_t length = strlen(text);
+    if (terminal->length + length > TERMINAL_OUTPUT_SIZE) FlushTerminal(terminal);
+    memcpy(terminal->output + terminal->length, text, length);
+    terminal->length += length;
+}
+
+static void ResolveTerminalCells(TerminalRenderer *terminal, const DrawList *list) {
+    RasterizeDrawList(list, &terminal->canvas, false);
+
+    const Color *pixels = terminal->canvas.data;
+    for (int row = 0; row < TERMINAL_ROWS; row++) {
+        for (int column = 0; column < TERMINAL_COLUMNS; column++) {
+            unsigned char top = GetTerminalColor(pixels[2 * row * TERMINAL_COLUMNS + column]);
+            unsigned char bottom = GetTerminalColor(pixels[(2 * row + 1) * TERMINAL_COLUMNS + column]);
+
+            // A cell of one color is a blank, whose foreground does not matter
+            if (top == bottom) terminal->cells[row][column] = (TerminalCell){ .fg = 0, .bg = bottom, .glyph = ' ' };
+            else terminal->cells[row][column] = (TerminalCell){ .fg = top, .bg = bottom };
+        }
+    }
+
+    // Glyphs at a cell per character are what stays readable, scaled text would not
+    float scaleX = (float)TERMINAL_COLUMNS / playfieldWidth;
+    float scaleY = (float)TERMINAL_ROWS / playfieldHeight;
+    for (int i = 0; i < list->count; i++) {
+        const DrawCommand *command = &list->commands[i];
+        if (command->type != DRAW_TEXT) continue;
+
+        int row = (int)((command->bounds.y + command->size / 2) * scaleY);
+        int column = (int)(command->bounds.x * scaleX);
+        if (row < 0 || row >= TERMINAL_ROWS) continue;
+
+        for (const char *c = list->labels[command->label]; *c != '\0' && column < TERMINAL_COLUMNS; c++, column++) {
+            if (column < 0) continue;
+            TerminalCell *cell = &terminal->cells[row][column];
+            *cell = (TerminalCell){ .fg = GetTerminalColor(command->color), .bg = cell->bg, .glyph = *c };
+        }
+    }
+}
+
+void DrawTerminal(TerminalRenderer *terminal, const DrawList *list) {
+    ResolveTerminalCells(terminal, list);
+
+    terminal->length = 0;
+    terminal->flushed = 0;
+    if (!terminal->cleared) {
+        AppendTerminal(terminal, "\x1b[?25l\x1b[0m\x1b[2J");
+        terminal->row = terminal->column = -1;
+        terminal->fg = terminal->bg = -1;
+    }
+
+    for (int row = 0; row < TERMINAL_ROWS; row++) {
+        for (int column = 0; column < TERMINAL_COLUMNS; column++) {
+            TerminalCell cell = terminal->cells[row][column];
+            TerminalCell *shown = &terminal->shown[row][column];
+            if (terminal->cleared && memcmp(&cell, shown, sizeof(TerminalCell)) == 0) continue;
+
+            // Skip the cursor move and color changes whenever the terminal is already there
+            if (terminal->row != row || terminal->column != column) AppendTerminal(terminal, TextFormat("\x1b[%d;%dH", row + 1, column + 1));
+            if (cell.glyph != ' ' && terminal->fg != cell.fg) {
+                AppendTerminal(terminal, TextFormat("\x1b[38;5;%dm", cell.fg));
+                terminal->fg = cell.fg;
+            }
+            if (terminal->bg != cell.bg) {
+                AppendTerminal(terminal, TextFormat("\x1b[48;5;%dm", cell.bg));
+                terminal->bg = cell.bg;
+            }
+            if (cell.glyph == 0) AppendTerminal(terminal, "\u2580"); // Upper half block
+            else AppendTerminal(terminal, (char[]){ cell.glyph, '\0' });
+            *shown = cell;
+
+            terminal->row = row;
+            terminal->column = column + 1;
+        }
+    }
+    terminal->cleared = true;
+
+    FlushTerminal(terminal);
+    if (terminal->flushed > 0) fflush(stdout);
+    terminal->bytes += terminal->flushed;
+    terminal->frames++;
+    if ((int)terminal->flushed > terminal->maxBytes) terminal->maxBytes = (int)terminal->flushed;
+}
+
+void UnloadTerminalRenderer(TerminalRenderer *terminal) {
+    if (terminal == NULL) return;
+
+    // Hand the terminal back in a usable state
+    if (terminal->cleared) {
+        printf("\x1b[0m\x1b[%d;1H\x1b[?25h\n", TERMINAL_ROWS);
+        fflush(stdout);
+    }
+    UnloadImage(terminal->canvas);
+    free(terminal->output);
+    free(terminal);
+}
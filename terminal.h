@@ -0,0 +1,48 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include <stdbool.h>
+
+#include "render.h"
+
+#define TERMINAL_COLUMNS 160
+#define TERMINAL_ROWS 45                // Each cell shows two pixels with a half block
+#define TERMINAL_OUTPUT_SIZE (256 * 1024)
+
+// One character cell: a half block showing fg above bg, or a text glyph. Colors
+// are xterm 256-color palette indices, which keep the escape sequences short.
+typedef struct {
+    unsigned char fg;
+    unsigned char bg;
+    char glyph;             // 0 for the half block
+} TerminalCell;
+
+// Draws into the terminal by diffing against what it already shows, so a frame
+// only costs the cells that changed (the ball and paddles in a live match)
+typedef struct {
+    Image canvas;           // TERMINAL_COLUMNS x 2 * TERMINAL_ROWS pixels
+    TerminalCell cells[TERMINAL_ROWS][TERMINAL_COLUMNS];
+    TerminalCell shown[TERMINAL_ROWS][TERMINAL_COLUMNS];
+    bool cleared;           // The screen was cleared and shown describes it
+    int row, column;        // Cursor position, -1 when unknown
+    int fg, bg;             // Current SGR colors, -1 when unknown
+    char *output;           // One frame of escape sequences, written in a single call unless it overflows
+    size_t length;
+    size_t flushed;         // Bytes of this frame already written out
+    unsigned long long bytes;
+    int frames;
+    int maxBytes;
+} TerminalRenderer;
+
+// Keyboard input for the terminal backend, whose hidden window never gets focus
+// and so never sees a key, and handing the terminal back however the game ends.
+// Raw mode, the restore at exit and on Ctrl-C or SIGTERM start together.
+bool StartTerminalInput(void);      // False when stdin is not a terminal to read keys from
+void StopTerminalInput(void);       // Restores the mode, colors and cursor; safe to call again
+int ReadTerminalByte(void);         // Next pending byte of input, -1 when there is none
+
+TerminalRenderer *LoadTerminalRenderer(void);
+void DrawTerminal(TerminalRenderer *terminal, const DrawList *list);
+void UnloadTerminalRenderer(TerminalRenderer *terminal);
+
+#endif // TERMINAL_H
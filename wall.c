@@ -0,0 +1,186 @@
+#include "game.h"
+#include "sim.h"
+
+// One match on the wall, AI against AI
+typedef struct {
+    Paddle left;
+    Paddle right;
+    Ball ball;
+    GameState state;
+} WallMatch;
+
+// Everything that moves is a textured quad from one atlas, so the whole wall goes
+// out as a single batch: the white block for paddles, a ball sprite and the digits.
+// The tile backgrounds and center lines are baked once per window size.
+typedef struct {
+    Texture2D atlas;
+    Rectangle white;
+    Rectangle ball;
+    Rectangle digits[10];
+    RenderTexture2D background;
+    int columns;
+    int rows;
+    float tileScale;            // Size of a tile's playfield relative to the whole playfield
+} WallView;
+
+static void ResetWallMatch(WallMatch *match) {
+    *match = (WallMatch){
+        .left = { { 50, playfieldHeight / 2 - PADDLE_HEIGHT / 2, PADDLE_WIDTH, PADDLE_HEIGHT }, 500.0f },
+        .right = { { playfieldWidth - 50 - PADDLE_WIDTH, playfieldHeight / 2 - PADDLE_HEIGHT / 2, PADDLE_WIDTH, PADDLE_HEIGHT }, 500.0f },
+        .state = { .currentScene = GAME, .aiPlayer = true },
+    };
+    ResetBall(&match->ball);
+}
+
+static void StepWallMatch(WallMatch *match) {
+    // GameLogic() drives the left paddle
+    SimInput input = { .down = GetDemoInput(&match->right, &match->ball) };
+
+    GameLogic(&match->left, &match->right, &match->ball, &match->state, &input, SIM_DT, NULL);
+    if (match->state.currentScene == GAME_OVER) ResetWallMatch(match);
+}
+
+static void LoadWallAtlas(WallView *view) {
+    // 64x64 cells: white, ball, then the digits. The white and ball regions keep a
+    // margin so bilinear filtering never samples a neighbour.
+    Image image = GenImageColor(12 * 64, 64, BLANK);
+    ImageDrawRectangle(&image, 0, 0, 64, 64, WHITE);
+    ImageDrawCircle(&image, 96, 32, 28, WHITE);
+    view->white = (Rectangle){ 16, 16, 32, 32 };
+    view->ball = (Rectangle){ 68, 4, 56, 56 };
+
+    for (int digit = 0; digit < 10; digit++) {
+        const char *text = TextFormat("%d", digit);
+        int x = (2 + digit) * 64 + 4;
+        ImageDrawText(&image, text, x, 7, 50, WHITE);
+        view->digits[digit] = (Rectangle){ x, 7, MeasureText(text, 50), 50 };
+    }
+
+    view->atlas = LoadTextureFromImage(image);
+    SetTextureFilter(view->atlas, TEXTURE_FILTER_BILINEAR);
+    UnloadImage(image);
+}
+
+static Vector2 GetTileOrigin(const WallView *view, int index) {
+    float tileWidth = (float)playfieldWidth / view->columns;
+    float tileHeight = (float)playfieldHeight / view->rows;
+    return (Vector2){
+        (index % view->columns) * tileWidth + (tileWidth - playfieldWidth * view->tileScale) / 2,
+        (index / view->columns) * tileHeight + (tileHeight - playfieldHeight * view->tileScale) / 2,
+    };
+}
+
+static void UpdateWallBackground(WallView *view, const ViewLayout *layout, int matches) {
+    if (view->background.id > 0) UnloadRenderTexture(view->background);
+    view->background = LoadRenderTexture(layout->windowWidth, layout->windowHeight);
+
+    float s = view->tileScale;
+    BeginTextureMode(view->background);
+    ClearBackground(BLACK);
+    BeginMode2D(layout->camera);
+    for (int i = 0; i < matches; i++) {
+        Vector2 origin = GetTileOrigin(view, i);
+        DrawRectangleRec((Rectangle){ origin.x, origin.y, playfieldWidth * s, playfieldHeight * s }, DARKGRAY);
+        for (float y = 0.0f; y < playfieldHeight; y += DASH_LENGTH + DASH_GAP) {
+            Rectangle dash = { playfieldWidth / 2 - DASH_THICKNESS / 2.0f, y, DASH_THICKNESS, fminf(DASH_LENGTH, playfieldHeight - y) };
+            DrawRectangleRec((Rectangle){ origin.x + dash.x * s, origin.y + dash.y * s, dash.width * s, dash.height * s }, GRAY);
+        }
+    }
+    EndMode2D();
+    EndTextureMode();
+}
+
+static void DrawWallQuad(const WallView *view, Rectangle source, Vector2 origin, Rectangle dest, Color color) {
+    float s = view->tileScale;
+    DrawTexturePro(view->atlas, source, (Rectangle){ origin.x + dest.x * s, origin.y + dest.y * s, dest.width * s, dest.height * s },
+                   (Vector2){ 0, 0 }, 0.0f, color);
+}
+
+static int DrawWallScore(const WallView *view, int score, Vector2 origin, Vector2 position) {
+    // Same place and size as the score in the full view: 80 high, DrawText() spacing
+    char text[8];
+    snprintf(text, sizeof(text), "%d", score);
+    int quads = 0;
+    for (const char *c = text; *c != '\0'; c++, quads++) {
+        Rectangle glyph = view->digits[*c - '0'];
+        float width = glyph.width * 80 / glyph.height;
+        DrawWallQuad(view, glyph, origin, (Rectangle){ position.x, position.y, width, 80 }, RAYWHITE);
+        position.x += width + 8;
+    }
+    return quads;
+}
+
+int RunWallView(const Config *config) {
+    unsigned int flags = FLAG_WINDOW_RESIZABLE;
+    if (config->vsync) flags |= FLAG_VSYNC_HINT;
+    if (config->msaa) flags |= FLAG_MSAA_4X_HINT;
+    SetConfigFlags(flags);
+    InitWindow(playfieldWidth, playfieldHeight, TextFormat("Pong wall, %d matches", config->wallMatches));
+    SetTargetFPS(config->targetFps);
+
+    int matches = config->wallMatches;
+    WallMatch *wall = malloc(matches * sizeof(WallMatch));
+    for (int i = 0; i < matches; i++) ResetWallMatch(&wall[i]);
+
+    WallView view = { 0 };
+    view.columns = (int)ceil(sqrt(matches));
+    view.rows = (matches + view.columns - 1) / view.columns;
+    view.tileScale = fminf(1.0f / view.columns, 1.0f / view.rows) * WALL_TILE_FILL;
+    LoadWallAtlas(&view);
+
+    ViewLayout layout = { 0 };
+    double accumulator = 0.0;
+    double updateTime = 0.0, drawTime = 0.0;
+    int frames = 0, quads = 0;
+
+    while (!WindowShouldClose()) {
+        if (UpdateViewLayout(&layout)) UpdateWallBackground(&view, &layout, matches);
+
+        double start = GetTime();
+        accumulator += GetFrameTime();
+        for (int ticks = 0; accumulator >= SIM_DT; ticks++) {
+            if (ticks == SIM_MAX_CATCHUP_TICKS) {
+                accumulator = 0.0;
+                break;
+            }
+            for (int i = 0; i < matches; i++) StepWallMatch(&wall[i]);
+            accumulator -= SIM_DT;
+        }
+        double drawStart = GetTime();
+
+        BeginDrawing();
+        DrawTextureRec(view.background.texture, (Rectangle){ 0, 0, layout.windowWidth, -layout.windowHeight }, (Vector2){ 0, 0 }, WHITE);
+
+        BeginMode2D(layout.camera);
+        quads = 0;
+        for (int i = 0; i < matches; i++) {
+            const WallMatch *match = &wall[i];
+            Vector2 origin = GetTileOrigin(&view, i);
+            DrawWallQuad(&view, view.white, origin, match->left.rect, RAYWHITE);
+            DrawWallQuad(&view, view.white, origin, match->right.rect, RAYWHITE);
+            DrawWallQuad(&view, view.ball, origin, (Rectangle){ match->ball.position.x - BALL_SIZE / 2, match->ball.position.y - BALL_SIZE / 2,
+                                                                BALL_SIZE, BALL_SIZE }, RAYWHITE);
+            quads += 3;
+            quads += DrawWallScore(&view, match->state.leftScore, origin, (Vector2){ playfieldWidth / 4, 20 });
+            quads += DrawWallScore(&view, match->state.rightScore, origin, (Vector2){ 3 * playfieldWidth / 4, 20 });
+        }
+        EndMode2D();
+
+        updateTime += drawStart - start;
+        drawTime += GetTime() - drawStart;
+        frames++;
+        DrawFPS(10, 10);
+        EndDrawing();
+    }
+
+    if (frames > 0) {
+        TraceLog(LOG_INFO, "WALL: %d matches, %d frames, update %.3f ms and draw %.3f ms per frame, %d quads in one batch",
+                 matches, frames, updateTime / frames * 1000.0, drawTime / frames * 1000.0, quads);
+    }
+
+    free(wall);
+    UnloadRenderTexture(view.background);
+    UnloadTexture(view.atlas);
+    CloseWindow();
+    return 0;
+}